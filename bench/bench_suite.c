@@ -0,0 +1,313 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "hal/hal.h"
+#include "lib/ssd1306.h"
+#include "src/calibration.h"
+#include "src/display.h"
+#include "src/e_series.h"
+#include "src/measurement.h"
+#include "src/resistor.h"
+#include "src/web_server.h"
+
+#if HAL_HOST
+#include <time.h>
+
+#include "sim/sim.h"
+#endif
+
+// Benchmarks dos caminhos críticos do firmware, com resultado em JSON para
+// comparar compilações. O mesmo código roda no simulador (bench_suite, alvo
+// "benchmark" do CMake) e no Pico (projeto_webserver_04_bench.uf2), medido
+// pelo timer de 1 MHz do RP2040 ou pelo relógio monotônico do host.
+//
+// Casos:
+//  - e_series_nearest nas séries E24 e E96, de 1 Ω a 10 MΩ (96 valores por década);
+//  - resistor_from_adc_sum (equação do divisor);
+//  - resistor_measure sobre o fluxo do ADC (sintético no simulador, o ADC
+//    real no Pico) com BENCH_MEASURE_MS de amostras acumuladas por chamada;
+//  - quadro completo do OLED (desenho + montagem da transferência) e
+//    atualização parcial (draw_display_measurement, só os campos alterados);
+//  - GET /api/measurement e GET / de tcp_server_recv até o tcp_output, em uma
+//    conexão keep-alive. Só no simulador: no Pico exigiria um cliente na rede.
+//
+// Uso no host: bench_suite [arquivo.json] (sem arquivo, o JSON vai para a
+// saída padrão). No Pico o JSON é impresso pela USB a cada BENCH_REPEAT_S, em
+// uma única linha começando por {"suite".
+
+#ifndef BENCH_BUILD_ID
+#define BENCH_BUILD_ID "unknown"
+#endif
+
+#define BENCH_RUNS 20
+#define BENCH_MEASURE_MS 20
+#define BENCH_DECADES 7
+#define BENCH_STEPS_PER_DECADE 96
+#define BENCH_REPEAT_S 10
+
+// Display (mesma ligação de main.c)
+#define BENCH_I2C_PORT 1
+#define BENCH_I2C_SDA 14
+#define BENCH_I2C_SCL 15
+#define BENCH_SSD1306_ADDRESS 0x3C
+#define BENCH_ADC_PIN 28
+
+typedef struct {
+  const char *name;
+  const char *per;       // unidade de cada operação medida
+  uint32_t runs;
+  uint32_t ops;          // operações somando todas as execuções
+  uint64_t total_ns;
+  uint64_t min_ns;       // menor tempo por operação entre as execuções
+  uint64_t max_ns;
+} bench_result_t;
+
+#define BENCH_MAX_RESULTS 12
+
+static bench_result_t bench_results[BENCH_MAX_RESULTS];
+static int bench_result_count = 0;
+
+static ohms_q8_t bench_values[BENCH_DECADES * BENCH_STEPS_PER_DECADE];
+static ssd1306_t bench_ssd;
+static volatile uint32_t bench_sink;
+
+// Relógio das medições. No RP2040 a resolução é a do timer (1 us), o que
+// basta porque os casos curtos são medidos em lotes.
+static inline uint64_t bench_now_ns(void) {
+#if HAL_HOST
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#else
+  return hal_time_us() * 1000u;
+#endif
+}
+
+static bench_result_t *bench_begin(const char *name, const char *per) {
+  bench_result_t *result = &bench_results[bench_result_count++];
+  memset(result, 0, sizeof(*result));
+  result->name = name;
+  result->per = per;
+  return result;
+}
+
+// Registra uma execução de ops operações que levou ns nanossegundos
+static void bench_add(bench_result_t *result, uint64_t ns, uint32_t ops) {
+  uint64_t per_op = ns / ops;
+
+  if (!result->runs || per_op < result->min_ns) {
+    result->min_ns = per_op;
+  }
+  if (per_op > result->max_ns) {
+    result->max_ns = per_op;
+  }
+  result->runs++;
+  result->ops += ops;
+  result->total_ns += ns;
+}
+
+static void bench_e_series(const char *name, e_series_t series) {
+  bench_result_t *result = bench_begin(name, "lookup");
+  const uint32_t count = sizeof(bench_values) / sizeof(bench_values[0]);
+  e_series_match_t match;
+
+  for (int run = 0; run < BENCH_RUNS; run++) {
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t i = 0; i < count; i++) {
+      e_series_nearest(series, bench_values[i], &match);
+      bench_sink += match.value;
+    }
+    bench_add(result, bench_now_ns() - t0, count);
+  }
+}
+
+static void bench_divider(void) {
+  bench_result_t *result = bench_begin("resistor_from_adc_sum", "conversion");
+  const uint32_t count = 4096;
+
+  for (int run = 0; run < BENCH_RUNS; run++) {
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t i = 0; i < count; i++) {
+      bench_sink += resistor_from_adc_sum(&resistor_ranges[1], i * ADC_FILTER_BLOCK_SAMPLES, ADC_FILTER_BLOCK_SAMPLES);
+    }
+    bench_add(result, bench_now_ns() - t0, count);
+  }
+}
+
+static void bench_resistor_measure(void) {
+  bench_result_t *result = bench_begin("resistor_measure", "call");
+  uint32_t samples;
+  bool stable;
+
+  // Enche o filtro antes de medir
+  resistor_measure(&samples, &stable);
+
+  for (int run = 0; run < BENCH_RUNS; run++) {
+    hal_sleep_ms(BENCH_MEASURE_MS);
+    // Amostras que chegaram durante a espera já ficam disponíveis (no
+    // simulador elas são geradas aqui, fora da medição)
+    hal_adc_stream_write_index();
+
+    uint64_t t0 = bench_now_ns();
+    bench_sink += resistor_measure(&samples, &stable);
+    bench_add(result, bench_now_ns() - t0, 1);
+  }
+}
+
+static void bench_wait_display(void) {
+  while (ssd1306_busy(&bench_ssd)) {
+    hal_sleep_us(100);
+  }
+}
+
+static void bench_display(void) {
+  bench_result_t *full = bench_begin("ssd1306_full_frame", "frame");
+  for (int run = 0; run < BENCH_RUNS; run++) {
+    bench_wait_display();
+
+    // Alterna o fundo para que todas as colunas mudem a cada quadro
+    uint64_t t0 = bench_now_ns();
+    ssd1306_fill(&bench_ssd, run & 1);
+    draw_display_layout(&bench_ssd);
+    ssd1306_draw_string(&bench_ssd, "4700 ohms", 29, 5);
+    ssd1306_draw_string(&bench_ssd, "amarelo", 60, 20);
+    ssd1306_draw_string(&bench_ssd, "violeta", 60, 31);
+    ssd1306_send_data_async(&bench_ssd);
+    bench_add(full, bench_now_ns() - t0, 1);
+  }
+  bench_wait_display();
+
+  measurement_t measurements[2] = {
+    { .e24 = ohms_q8_from_int(4700), .bands = {4, 7, 2} },
+    { .e24 = ohms_q8_from_int(5100), .bands = {5, 1, 2} },
+  };
+  bench_result_t *partial = bench_begin("draw_display_measurement", "frame");
+  for (int run = 0; run < BENCH_RUNS; run++) {
+    bench_wait_display();
+
+    uint64_t t0 = bench_now_ns();
+    draw_display_measurement(&bench_ssd, &measurements[run & 1]);
+    bench_add(partial, bench_now_ns() - t0, 1);
+  }
+  bench_wait_display();
+}
+
+#if HAL_HOST
+static void bench_http(const char *name, const char *request) {
+  struct tcp_pcb *pcb = sim_lwip_detached_pcb();
+  if (!pcb || tcp_server_accept(NULL, pcb, ERR_OK) != ERR_OK) {
+    return;
+  }
+
+  bench_result_t *result = bench_begin(name, "request");
+  for (int run = 0; run < BENCH_RUNS * 10; run++) {
+    uint64_t t0 = bench_now_ns();
+    uint32_t written = sim_lwip_inject(pcb, request, (uint16_t)strlen(request));
+    bench_add(result, bench_now_ns() - t0, 1);
+    bench_sink += written;
+
+    // Confirma o envio (callback sent), liberando a resposta para a próxima
+    sim_lwip_poll(0);
+  }
+  tcp_abort(pcb);
+}
+#endif
+
+static void bench_setup(void) {
+  for (int i = 0; i < BENCH_DECADES * BENCH_STEPS_PER_DECADE; i++) {
+    double ohms = pow(10.0, (double)i / BENCH_STEPS_PER_DECADE);
+    bench_values[i] = (ohms_q8_t)(ohms * OHMS_Q8_ONE + 0.5);
+  }
+
+  hal_i2c_init(BENCH_I2C_PORT, 400000, BENCH_I2C_SDA, BENCH_I2C_SCL);
+  ssd1306_init(&bench_ssd, WIDTH, HEIGHT, false, BENCH_SSD1306_ADDRESS, BENCH_I2C_PORT);
+  ssd1306_config(&bench_ssd);
+
+#if HAL_HOST
+  sim_adc_set_unknown(4700.0f);
+#endif
+  hal_adc_init(BENCH_ADC_PIN);
+  calibration_init();
+  resistor_setup();
+
+#if HAL_HOST
+  // Medição publicada para as respostas HTTP
+  measurement_t m = {
+    .measured = ohms_q8_from_int(4712),
+    .e24 = ohms_q8_from_int(4700),
+    .bands = {4, 7, 2},
+    .range = 1,
+    .samples = 1024,
+  };
+  measurement_publish(&m);
+  web_server_init();
+  web_server_update_response();
+#endif
+}
+
+static void bench_print_json(FILE *out) {
+  fprintf(out, "{\"suite\":\"projeto_webserver_04\",\"build\":\"%s\",", BENCH_BUILD_ID);
+#if HAL_HOST
+  fprintf(out, "\"platform\":\"host\",\"timer\":\"clock_monotonic_ns\",");
+#else
+  fprintf(out, "\"platform\":\"rp2040\",\"timer\":\"rp2040_timer_1mhz\",");
+#endif
+  fprintf(out, "\"results\":[");
+  for (int i = 0; i < bench_result_count; i++) {
+    const bench_result_t *r = &bench_results[i];
+    fprintf(out, "%s{\"name\":\"%s\",\"per\":\"%s\",\"runs\":%lu,\"ops\":%lu,"
+                 "\"mean_ns\":%.1f,\"min_ns\":%llu,\"max_ns\":%llu}",
+            i ? "," : "", r->name, r->per, (unsigned long)r->runs, (unsigned long)r->ops,
+            r->ops ? (double)r->total_ns / r->ops : 0.0,
+            (unsigned long long)r->min_ns, (unsigned long long)r->max_ns);
+  }
+  fprintf(out, "]}\n");
+}
+
+static void bench_run(void) {
+  bench_result_count = 0;
+  bench_e_series("e_series_nearest_e24", E_SERIES_E24);
+  bench_e_series("e_series_nearest_e96", E_SERIES_E96);
+  bench_divider();
+  bench_resistor_measure();
+  bench_display();
+#if HAL_HOST
+  bench_http("http_get_measurement", "GET /api/measurement HTTP/1.1\r\nHost: bench\r\n\r\n");
+  bench_http("http_get_page", "GET / HTTP/1.1\r\nHost: bench\r\nAccept-Encoding: gzip\r\n\r\n");
+#endif
+}
+
+int main(int argc, char **argv) {
+  hal_stdio_init();
+
+#if HAL_HOST
+  bench_setup();
+  bench_run();
+
+  FILE *out = argc > 1 ? fopen(argv[1], "w") : stdout;
+  if (!out) {
+    perror(argv[1]);
+    return 1;
+  }
+  bench_print_json(out);
+  if (out != stdout) {
+    fclose(out);
+    printf("Resultados gravados em %s\n", argv[1]);
+  }
+  return 0;
+#else
+  (void)argc;
+  (void)argv;
+
+  // Tempo para o terminal USB conectar
+  hal_sleep_ms(3000);
+  bench_setup();
+
+  while (true) {
+    bench_run();
+    bench_print_json(stdout);
+    hal_sleep_ms(BENCH_REPEAT_S * 1000u);
+  }
+#endif
+}
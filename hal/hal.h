@@ -0,0 +1,195 @@
+#ifndef HAL_H
+#define HAL_H
+
+/*
+ * Camada de abstração de hardware (HAL).
+ *
+ * O firmware (main.c, src/ e lib/ssd1306.c) só acessa o hardware através destas
+ * funções. Existem duas implementações:
+ *  - hal/hal_pico.c : Raspberry Pi Pico W (Pico SDK + cyw43 + lwIP)
+ *  - sim/hal_host.c : simulador para Linux (ADC simulado, OLED em memória e
+ *                     lwIP emulado sobre sockets no loopback)
+ *
+ * A pilha de rede continua sendo a API "raw" do lwIP (lwip/tcp.h, lwip/pbuf.h),
+ * que no simulador é fornecida por sim/lwip_shim.c.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if HAL_HOST
+#include <sys/types.h>
+typedef unsigned int uint;
+#endif
+
+// ---------------------------------- Sistema ----------------------------------
+
+// Inicializa a saída padrão (USB/UART no Pico, stdout no simulador)
+void hal_stdio_init(void);
+
+// Reinicia o dispositivo no modo BOOTSEL (no simulador, encerra o processo)
+void hal_reset_to_bootloader(void);
+
+// ---------------------------------- Tempo ------------------------------------
+
+// Tempo desde o boot em milissegundos / microssegundos
+uint32_t hal_time_ms(void);
+uint64_t hal_time_us(void);
+
+void hal_sleep_ms(uint32_t ms);
+void hal_sleep_us(uint64_t us);
+
+// Contador de microssegundos de 32 bits (volta a cada ~71 min) para medir
+// trechos curtos. O Cortex-M0+ do RP2040 não tem contador de ciclos (DWT),
+// então no Pico é uma única leitura do registrador do timer de 1 MHz.
+#if HAL_HOST
+uint32_t hal_timer_us32(void);
+#else
+#include "hardware/timer.h"
+static inline uint32_t hal_timer_us32(void) {
+  return time_us_32();
+}
+#endif
+
+// --------------------------------- Eventos -----------------------------------
+
+// Espera de baixo consumo: o núcleo dorme (WFE no RP2040) até um sinal de
+// hal_event_signal(), de qualquer núcleo ou interrupção, uma interrupção
+// atendida por ele ou o fim do prazo. Como o WFE, pode retornar antes do
+// motivo esperado; um sinal dado desde a espera anterior faz a próxima
+// retornar de imediato. No simulador o núcleo 0 atende a rede enquanto espera.
+void hal_event_signal(void);
+void hal_event_wait(uint32_t timeout_us);
+
+// -------------------------------- Multinúcleo --------------------------------
+
+// Executa entry no núcleo 1 (no simulador, em uma thread separada). A função
+// não deve retornar. Apenas o núcleo 0 pode chamar as funções de rede.
+void hal_core1_launch(void (*entry)(void));
+
+// Barreira de memória completa (compilador e hardware) para dados
+// compartilhados entre os núcleos
+void hal_memory_barrier(void);
+
+// --------------------------------- GPIO / IRQ --------------------------------
+
+// Máscaras de evento compatíveis com GPIO_IRQ_EDGE_* do Pico SDK
+#define HAL_GPIO_IRQ_EDGE_FALL 0x4u
+#define HAL_GPIO_IRQ_EDGE_RISE 0x8u
+
+typedef void (*hal_gpio_irq_callback_t)(uint gpio, uint32_t events);
+
+void hal_gpio_init_input_pullup(uint gpio);
+void hal_gpio_init_output(uint gpio);
+
+// Entrada sem resistores de pull: o pino fica em alta impedância
+void hal_gpio_init_input(uint gpio);
+
+void hal_gpio_put(uint gpio, bool value);
+bool hal_gpio_get(uint gpio);
+
+// Habilita a interrupção do pino. Assim como no SDK, o callback é único e
+// compartilhado por todos os pinos.
+void hal_gpio_set_irq(uint gpio, uint32_t events, hal_gpio_irq_callback_t callback);
+
+// ----------------------------------- ADC -------------------------------------
+
+#define HAL_ADC_MAX_VALUE 4095u
+
+// Inicializa o ADC e configura o pino (GPIO 26-29) como entrada analógica
+void hal_adc_init(uint gpio);
+void hal_adc_select_input(uint input);
+uint16_t hal_adc_read(void);
+
+// Aquisição contínua: o ADC opera em modo free-running (FIFO) na taxa indicada
+// e as amostras são gravadas por DMA em um buffer circular de 2^ring_bits
+// amostras, sem uso da CPU. O buffer deve estar alinhado ao seu tamanho em
+// bytes (exigência do modo ring do DMA). Enquanto ativa, hal_adc_read() não
+// deve ser usada. O callback (opcional) é chamado em interrupção a cada bloco
+// de 2^block_bits amostras gravadas (block_bits <= ring_bits); no simulador,
+// em uma thread que imita o DMA.
+typedef void (*hal_adc_callback_t)(void *arg);
+
+bool hal_adc_stream_start(uint input, uint32_t sample_rate_hz, volatile uint16_t *ring, uint8_t ring_bits,
+                          uint8_t block_bits, hal_adc_callback_t callback, void *arg);
+void hal_adc_stream_stop(void);
+
+// Posição (em amostras) onde o DMA fará a próxima escrita no buffer circular
+uint32_t hal_adc_stream_write_index(void);
+
+// ----------------------------------- I2C -------------------------------------
+
+// Porta I2C identificada pelo número da instância (0 = i2c0, 1 = i2c1)
+typedef uint8_t hal_i2c_port_t;
+
+void hal_i2c_init(hal_i2c_port_t port, uint32_t baudrate, uint sda, uint scl);
+
+// Escrita bloqueante. Retorna o número de bytes escritos ou valor negativo em caso de erro.
+int hal_i2c_write(hal_i2c_port_t port, uint8_t address, const uint8_t *src, size_t len, bool nostop);
+
+// Escrita assíncrona por DMA de uma sequência de transações para o mesmo
+// endereço. Cada elemento de src carrega um byte nos bits 0-7; HAL_I2C_STOP
+// encerra a transação após aquele byte (a próxima começa com um novo START).
+// O buffer deve permanecer válido até o fim da transferência. Retorna false
+// se a porta ainda estiver ocupada. O callback (opcional) é chamado em
+// interrupção quando o DMA termina; no simulador a transferência é concluída
+// antes do retorno.
+#define HAL_I2C_STOP 0x200u // mesmo bit STOP do registrador IC_DATA_CMD do RP2040
+
+typedef void (*hal_i2c_callback_t)(void *arg);
+
+bool hal_i2c_write_async(hal_i2c_port_t port, uint8_t address, const uint16_t *src, size_t len,
+                         hal_i2c_callback_t callback, void *arg);
+
+// Indica se ainda há uma transferência assíncrona em andamento na porta
+bool hal_i2c_busy(hal_i2c_port_t port);
+
+// ---------------------------------- Flash ------------------------------------
+
+// Área da flash reservada para dados do firmware (calibração, registros). No
+// Pico ocupa o fim da flash; no simulador é um arquivo mapeado em memória
+// (SIM_FLASH) ou, sem ele, memória volátil. Os offsets são relativos ao
+// início da área.
+#define HAL_FLASH_SECTOR_SIZE 4096u
+#define HAL_FLASH_PAGE_SIZE 256u
+#define HAL_FLASH_DATA_SIZE (16u * HAL_FLASH_SECTOR_SIZE)
+
+// Conteúdo da área para leitura direta (pela XIP no Pico)
+const uint8_t *hal_flash_data(void);
+
+// Apaga os setores [offset, offset + len) (todos os bits em 1). offset e len
+// devem ser múltiplos de HAL_FLASH_SECTOR_SIZE.
+bool hal_flash_erase(uint32_t offset, size_t len);
+
+// Grava páginas já apagadas (a gravação só leva bits de 1 para 0). offset e
+// len devem ser múltiplos de HAL_FLASH_PAGE_SIZE e src deve estar na RAM.
+// Durante a operação nenhum dos núcleos executa código da flash.
+bool hal_flash_program(uint32_t offset, const void *src, size_t len);
+
+// ----------------------------------- Rede ------------------------------------
+
+// Inicializa a interface de rede (cyw43 no Pico). Retorna 0 em caso de sucesso.
+int hal_net_init(void);
+
+// Conecta ao ponto de acesso (modo station). Retorna 0 em caso de sucesso.
+int hal_net_connect(const char *ssid, const char *password, uint32_t timeout_ms);
+
+// LED do CI de rede (CYW43_WL_GPIO_LED_PIN no Pico W)
+void hal_net_led_put(bool value);
+
+// Endereço IP da interface padrão em texto (ou NULL se não houver)
+const char *hal_net_ip_address(void);
+
+// Processamento exigido pelo driver de rede / pilha TCP/IP
+void hal_net_poll(void);
+
+// Exclusão mútua com os callbacks do lwIP. No modo threadsafe_background os
+// callbacks executam em interrupção, então dados compartilhados com eles devem
+// ser alterados dentro deste par de chamadas.
+void hal_net_lock(void);
+void hal_net_unlock(void);
+
+void hal_net_deinit(void);
+
+#endif // HAL_H
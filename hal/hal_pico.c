@@ -0,0 +1,428 @@
+#include <stdio.h>
+
+#include "hal/hal.h"
+
+#include "pico/stdlib.h"         // Biblioteca da Raspberry Pi Pico para funções padrão (GPIO, temporização, etc.)
+#include "pico/bootrom.h"
+#include "pico/multicore.h"
+#include "pico/flash.h"
+#include "hardware/sync.h"
+#include "hardware/adc.h"        // Biblioteca da Raspberry Pi Pico para manipulação do conversor ADC
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/flash.h"
+#include "hardware/irq.h"
+#include "pico/cyw43_arch.h"     // Biblioteca para arquitetura Wi-Fi da Pico com CYW43
+
+#include "lwip/netif.h"          // Lightweight IP stack - fornece funções e estruturas para trabalhar com interfaces de rede (netif)
+
+static hal_gpio_irq_callback_t gpio_irq_callback = NULL;
+
+// Transferências I2C assíncronas (um canal de DMA por porta, alocado no primeiro uso)
+static int i2c_dma_channel[2] = {-1, -1};
+static hal_i2c_callback_t i2c_dma_callback[2];
+static void *i2c_dma_callback_arg[2];
+
+static inline i2c_inst_t *hal_i2c_instance(hal_i2c_port_t port) {
+  return port ? i2c1 : i2c0;
+}
+
+// ---------------------------------- Sistema ----------------------------------
+
+void hal_stdio_init(void) {
+  stdio_init_all();
+}
+
+void hal_reset_to_bootloader(void) {
+  reset_usb_boot(0, 0);
+}
+
+// ---------------------------------- Tempo ------------------------------------
+
+uint32_t hal_time_ms(void) {
+  return to_ms_since_boot(get_absolute_time());
+}
+
+uint64_t hal_time_us(void) {
+  return time_us_64();
+}
+
+void hal_sleep_ms(uint32_t ms) {
+  sleep_ms(ms);
+}
+
+void hal_sleep_us(uint64_t us) {
+  sleep_us(us);
+}
+
+// --------------------------------- Eventos -----------------------------------
+
+void hal_event_signal(void) {
+  __sev();
+}
+
+void hal_event_wait(uint32_t timeout_us) {
+  // O alarme do SDK executa um SEV no fim do prazo e acorda o WFE
+  best_effort_wfe_or_timeout(make_timeout_time_us(timeout_us));
+}
+
+// -------------------------------- Multinúcleo --------------------------------
+
+void hal_core1_launch(void (*entry)(void)) {
+  multicore_launch_core1(entry);
+
+  // Permite que o núcleo 1 pause o núcleo 0 ao gravar a flash (flash_safe_execute)
+  multicore_lockout_victim_init();
+}
+
+void hal_memory_barrier(void) {
+  __dmb();
+}
+
+// --------------------------------- GPIO / IRQ --------------------------------
+
+static void hal_gpio_irq_dispatch(uint gpio, uint32_t events) {
+  if (gpio_irq_callback) {
+    gpio_irq_callback(gpio, events);
+  }
+}
+
+void hal_gpio_init_input_pullup(uint gpio) {
+  gpio_init(gpio);
+  gpio_set_dir(gpio, GPIO_IN);
+  gpio_pull_up(gpio);
+}
+
+void hal_gpio_init_output(uint gpio) {
+  gpio_init(gpio);
+  gpio_set_dir(gpio, GPIO_OUT);
+}
+
+void hal_gpio_put(uint gpio, bool value) {
+  gpio_put(gpio, value);
+}
+
+void hal_gpio_init_input(uint gpio) {
+  gpio_init(gpio);
+  gpio_set_dir(gpio, GPIO_IN);
+  gpio_disable_pulls(gpio);
+}
+
+bool hal_gpio_get(uint gpio) {
+  return gpio_get(gpio);
+}
+
+void hal_gpio_set_irq(uint gpio, uint32_t events, hal_gpio_irq_callback_t callback) {
+  gpio_irq_callback = callback;
+  gpio_set_irq_enabled_with_callback(gpio, events, true, &hal_gpio_irq_dispatch);
+}
+
+// ----------------------------------- ADC -------------------------------------
+
+void hal_adc_init(uint gpio) {
+  adc_init();
+  adc_gpio_init(gpio);
+}
+
+void hal_adc_select_input(uint input) {
+  adc_select_input(input);
+}
+
+uint16_t hal_adc_read(void) {
+  return adc_read();
+}
+
+// Canal de dados: FIFO do ADC -> buffer circular (modo ring na escrita).
+// Canal de controle: ao fim de cada bloco recarrega o contador do canal de
+// dados pelo alias que dispara a transferência, mantendo a captura contínua.
+static int adc_dma_data = -1;
+static int adc_dma_ctrl = -1;
+static volatile uint16_t *adc_ring = NULL;
+static uint32_t adc_ring_mask = 0;
+static uint32_t adc_ring_transfer_count = 0;
+static hal_adc_callback_t adc_callback = NULL;
+static void *adc_callback_arg = NULL;
+
+// Fim de um bloco do canal de dados (o canal de controle já o reiniciou)
+static void hal_adc_dma_irq(void) {
+  if (adc_dma_data >= 0 && dma_channel_get_irq1_status(adc_dma_data)) {
+    dma_channel_acknowledge_irq1(adc_dma_data);
+    if (adc_callback) {
+      adc_callback(adc_callback_arg);
+    }
+  }
+}
+
+bool hal_adc_stream_start(uint input, uint32_t sample_rate_hz, volatile uint16_t *ring, uint8_t ring_bits,
+                          uint8_t block_bits, hal_adc_callback_t callback, void *arg) {
+  static bool irq_installed = false;
+
+  if (adc_dma_data >= 0 || !sample_rate_hz || ring_bits + 1 > 15 || block_bits > ring_bits) {
+    return false;
+  }
+
+  adc_ring = ring;
+  adc_ring_mask = (1u << ring_bits) - 1;
+  adc_callback = callback;
+  adc_callback_arg = arg;
+
+  // Cada disparo grava um bloco; o endereço de escrita segue dando a volta no
+  // buffer (modo ring), então blocos menores que o buffer só antecipam a IRQ
+  adc_ring_transfer_count = 1u << block_bits;
+
+  adc_select_input(input);
+  adc_fifo_setup(
+    true,   // habilita a FIFO
+    true,   // DREQ para o DMA
+    1,      // DREQ a cada amostra
+    false,  // sem bit de erro
+    false   // amostras de 12 bits (sem deslocamento para 8 bits)
+  );
+
+  // Cada conversão leva (1 + div) ciclos do clock de 48 MHz do ADC
+  float div = 48000000.0f / (float)sample_rate_hz - 1.0f;
+  adc_set_clkdiv(div < 0.0f ? 0.0f : div);
+
+  adc_dma_data = dma_claim_unused_channel(true);
+  adc_dma_ctrl = dma_claim_unused_channel(true);
+
+  dma_channel_config data_cfg = dma_channel_get_default_config(adc_dma_data);
+  channel_config_set_transfer_data_size(&data_cfg, DMA_SIZE_16);
+  channel_config_set_read_increment(&data_cfg, false);
+  channel_config_set_write_increment(&data_cfg, true);
+  channel_config_set_ring(&data_cfg, true, ring_bits + 1); // tamanho do buffer em bytes
+  channel_config_set_dreq(&data_cfg, DREQ_ADC);
+  channel_config_set_chain_to(&data_cfg, adc_dma_ctrl);
+  dma_channel_configure(adc_dma_data, &data_cfg, ring, &adc_hw->fifo, adc_ring_transfer_count, false);
+
+  dma_channel_config ctrl_cfg = dma_channel_get_default_config(adc_dma_ctrl);
+  channel_config_set_transfer_data_size(&ctrl_cfg, DMA_SIZE_32);
+  channel_config_set_read_increment(&ctrl_cfg, false);
+  channel_config_set_write_increment(&ctrl_cfg, false);
+  dma_channel_configure(adc_dma_ctrl, &ctrl_cfg,
+                        &dma_hw->ch[adc_dma_data].al1_transfer_count_trig,
+                        &adc_ring_transfer_count, 1, false);
+
+  if (callback) {
+    // DMA_IRQ_1, compartilhada com as transferências I2C
+    dma_channel_set_irq1_enabled(adc_dma_data, true);
+    if (!irq_installed) {
+      irq_add_shared_handler(DMA_IRQ_1, hal_adc_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+      irq_installed = true;
+    }
+    irq_set_enabled(DMA_IRQ_1, true);
+  }
+
+  adc_fifo_drain();
+  dma_channel_start(adc_dma_data);
+  adc_run(true);
+  return true;
+}
+
+void hal_adc_stream_stop(void) {
+  if (adc_dma_data < 0) {
+    return;
+  }
+
+  adc_run(false);
+  dma_channel_set_irq1_enabled(adc_dma_data, false);
+  dma_channel_abort(adc_dma_ctrl);
+  dma_channel_abort(adc_dma_data);
+  dma_channel_acknowledge_irq1(adc_dma_data);
+  dma_channel_unclaim(adc_dma_ctrl);
+  dma_channel_unclaim(adc_dma_data);
+  adc_fifo_setup(false, false, 0, false, false);
+  adc_fifo_drain();
+  adc_dma_data = adc_dma_ctrl = -1;
+}
+
+uint32_t hal_adc_stream_write_index(void) {
+  uintptr_t write_addr = dma_hw->ch[adc_dma_data].write_addr;
+  return ((write_addr - (uintptr_t)adc_ring) / sizeof(uint16_t)) & adc_ring_mask;
+}
+
+// ----------------------------------- I2C -------------------------------------
+
+void hal_i2c_init(hal_i2c_port_t port, uint32_t baudrate, uint sda, uint scl) {
+  i2c_init(hal_i2c_instance(port), baudrate);
+
+  gpio_set_function(sda, GPIO_FUNC_I2C);
+  gpio_set_function(scl, GPIO_FUNC_I2C);
+  gpio_pull_up(sda);
+  gpio_pull_up(scl);
+}
+
+int hal_i2c_write(hal_i2c_port_t port, uint8_t address, const uint8_t *src, size_t len, bool nostop) {
+  // Aguarda uma eventual transferência assíncrona na mesma porta
+  while (hal_i2c_busy(port)) {
+    tight_loop_contents();
+  }
+  return i2c_write_blocking(hal_i2c_instance(port), address, src, len, nostop);
+}
+
+static void hal_i2c_dma_irq(void) {
+  for (hal_i2c_port_t port = 0; port < 2; port++) {
+    int channel = i2c_dma_channel[port];
+    if (channel >= 0 && dma_channel_get_irq1_status(channel)) {
+      dma_channel_acknowledge_irq1(channel);
+      if (i2c_dma_callback[port]) {
+        i2c_dma_callback[port](i2c_dma_callback_arg[port]);
+      }
+    }
+  }
+}
+
+bool hal_i2c_write_async(hal_i2c_port_t port, uint8_t address, const uint16_t *src, size_t len,
+                         hal_i2c_callback_t callback, void *arg) {
+  if (hal_i2c_busy(port)) {
+    return false;
+  }
+
+  i2c_inst_t *i2c = hal_i2c_instance(port);
+  i2c_hw_t *hw = i2c_get_hw(i2c);
+  int channel = i2c_dma_channel[port];
+
+  if (channel < 0) {
+    channel = dma_claim_unused_channel(true);
+    i2c_dma_channel[port] = channel;
+
+    // DMA_IRQ_1 fica livre para a aplicação (o driver do cyw43 não o utiliza)
+    dma_channel_set_irq1_enabled(channel, true);
+    irq_add_shared_handler(DMA_IRQ_1, hal_i2c_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+  }
+
+  i2c_dma_callback[port] = callback;
+  i2c_dma_callback_arg[port] = arg;
+
+  // O endereço do escravo só pode ser alterado com o controlador desabilitado
+  hw->enable = 0;
+  hw->tar = address;
+  hw->enable = 1;
+
+  // Cada meia-palavra vai direto para IC_DATA_CMD (byte + bit STOP)
+  dma_channel_config cfg = dma_channel_get_default_config(channel);
+  channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+  channel_config_set_read_increment(&cfg, true);
+  channel_config_set_write_increment(&cfg, false);
+  channel_config_set_dreq(&cfg, i2c_get_dreq(i2c, true));
+  dma_channel_configure(channel, &cfg, &hw->data_cmd, src, len, true);
+  return true;
+}
+
+bool hal_i2c_busy(hal_i2c_port_t port) {
+  int channel = i2c_dma_channel[port];
+  if (channel < 0) {
+    return false;
+  }
+
+  i2c_hw_t *hw = i2c_get_hw(hal_i2c_instance(port));
+
+  // Sem ACK do escravo o controlador descarta a FIFO: encerra a transferência
+  if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+    dma_channel_abort(channel);
+    (void)hw->clr_tx_abrt;
+  }
+
+  return dma_channel_is_busy(channel) ||
+         !(hw->status & I2C_IC_STATUS_TFE_BITS) ||
+         (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS);
+}
+
+// ---------------------------------- Flash ------------------------------------
+
+#define HAL_FLASH_DATA_OFFSET (PICO_FLASH_SIZE_BYTES - HAL_FLASH_DATA_SIZE)
+
+typedef struct {
+  uint32_t offset;
+  const void *src;
+  size_t len;
+} hal_flash_op_t;
+
+static bool hal_flash_range_valid(uint32_t offset, size_t len, uint32_t alignment) {
+  return !(offset % alignment) && !(len % alignment) &&
+         offset <= HAL_FLASH_DATA_SIZE && len <= HAL_FLASH_DATA_SIZE - offset;
+}
+
+// Executadas pelo flash_safe_execute, com as interrupções desabilitadas e o
+// outro núcleo parado na RAM
+static void hal_flash_do_erase(void *param) {
+  const hal_flash_op_t *op = param;
+  flash_range_erase(HAL_FLASH_DATA_OFFSET + op->offset, op->len);
+}
+
+static void hal_flash_do_program(void *param) {
+  const hal_flash_op_t *op = param;
+  flash_range_program(HAL_FLASH_DATA_OFFSET + op->offset, op->src, op->len);
+}
+
+const uint8_t *hal_flash_data(void) {
+  return (const uint8_t *)(XIP_BASE + HAL_FLASH_DATA_OFFSET);
+}
+
+bool hal_flash_erase(uint32_t offset, size_t len) {
+  if (!hal_flash_range_valid(offset, len, HAL_FLASH_SECTOR_SIZE)) {
+    return false;
+  }
+
+  hal_flash_op_t op = { offset, NULL, len };
+  return flash_safe_execute(hal_flash_do_erase, &op, UINT32_MAX) == PICO_OK;
+}
+
+bool hal_flash_program(uint32_t offset, const void *src, size_t len) {
+  if (!hal_flash_range_valid(offset, len, HAL_FLASH_PAGE_SIZE)) {
+    return false;
+  }
+
+  hal_flash_op_t op = { offset, src, len };
+  return flash_safe_execute(hal_flash_do_program, &op, UINT32_MAX) == PICO_OK;
+}
+
+// ----------------------------------- Rede ------------------------------------
+
+int hal_net_init(void) {
+  if (cyw43_arch_init()) {
+    return -1;
+  }
+
+  // Ativa o Wi-Fi no modo Station, de modo a que possam ser feitas ligações a outros pontos de acesso Wi-Fi.
+  cyw43_arch_enable_sta_mode();
+  return 0;
+}
+
+int hal_net_connect(const char *ssid, const char *password, uint32_t timeout_ms) {
+  return cyw43_arch_wifi_connect_timeout_ms(ssid, password, CYW43_AUTH_WPA2_AES_PSK, timeout_ms);
+}
+
+void hal_net_led_put(bool value) {
+  cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, value);
+}
+
+const char *hal_net_ip_address(void) {
+  // Caso seja a interface de rede padrão - retorna o IP do dispositivo.
+  if (netif_default) {
+    return ipaddr_ntoa(&netif_default->ip_addr);
+  }
+  return NULL;
+}
+
+void hal_net_poll(void) {
+  /*
+  * Efetuar o processamento exigido pelo cyw43_driver ou pela stack TCP/IP.
+  * Este método deve ser chamado periodicamente a partir do ciclo principal
+  * quando se utiliza um estilo de sondagem pico_cyw43_arch
+  */
+  cyw43_arch_poll();
+}
+
+void hal_net_lock(void) {
+  cyw43_arch_lwip_begin();
+}
+
+void hal_net_unlock(void) {
+  cyw43_arch_lwip_end();
+}
+
+void hal_net_deinit(void) {
+  cyw43_arch_deinit();
+}
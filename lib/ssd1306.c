@@ -1,16 +1,37 @@
+#include <stdlib.h>
+#include <string.h>
+
 #include "ssd1306.h"
 #include "font.h"
+#include "src/metrics.h"
+
+// Bytes extras para abrir uma janela: transação de comandos (endereço, controle
+// e 6 bytes de comando) e byte de endereço + controle da transação de dados
+#define SSD1306_WINDOW_OVERHEAD 10
+
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, hal_i2c_port_t i2c) {
+  if (width > SSD1306_MAX_WIDTH) {
+    width = SSD1306_MAX_WIDTH;
+  }
+  if (height > SSD1306_MAX_PAGES * 8U) {
+    height = SSD1306_MAX_PAGES * 8U;
+  }
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
   ssd->width = width;
   ssd->height = height;
   ssd->pages = height / 8U;
   ssd->address = address;
   ssd->i2c_port = i2c;
   ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->tx_len = ssd->bufsize + SSD1306_MAX_PAGES * SSD1306_WINDOW_COMMAND_WORDS;
+  memset(ssd->ram_buffer, 0, sizeof(ssd->ram_buffer));
+  memset(ssd->sent_buffer, 0, sizeof(ssd->sent_buffer));
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->sent_callback = NULL;
+
+  // O conteúdo inicial da GDDRAM é desconhecido
+  ssd1306_invalidate(ssd);
 }
 
 void ssd1306_config(ssd1306_t *ssd) {
@@ -43,7 +64,7 @@ void ssd1306_config(ssd1306_t *ssd) {
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   ssd->port_buffer[1] = command;
-  i2c_write_blocking(
+  hal_i2c_write(
     ssd->i2c_port,
     ssd->address,
     ssd->port_buffer,
@@ -52,69 +73,269 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   );
 }
 
-void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+// Vários comandos em uma única transação (byte de controle 0x00 => Co = 0, D/C# = 0)
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t len) {
+  uint8_t buffer[8];
+  buffer[0] = 0x00;
+
+  while (len) {
+    size_t chunk = len < sizeof(buffer) - 1 ? len : sizeof(buffer) - 1;
+    for (size_t i = 0; i < chunk; i++) {
+      buffer[i + 1] = commands[i];
+    }
+    hal_i2c_write(ssd->i2c_port, ssd->address, buffer, chunk + 1, false);
+    commands += chunk;
+    len -= chunk;
+  }
 }
 
-void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
-  uint8_t pixel = (y & 0b111);
-  if (value)
-    ssd->ram_buffer[index] |= (1 << pixel);
-  else
-    ssd->ram_buffer[index] &= ~(1 << pixel);
+void ssd1306_invalidate(ssd1306_t *ssd) {
+  ssd->full_refresh = true;
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    ssd->dirty_start[page] = 0;
+    ssd->dirty_end[page] = ssd->width - 1;
+  }
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+static inline bool ssd1306_page_dirty(ssd1306_t *ssd, uint8_t page) {
+  return ssd->dirty_start[page] <= ssd->dirty_end[page];
+}
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
+// Reduz a faixa alterada da página às colunas que diferem do que já está no
+// display. Redesenhos completos (limpa e desenha de novo) marcam a tela toda,
+// mas normalmente só alteram poucas colunas.
+static void ssd1306_trim_page(ssd1306_t *ssd, uint8_t page) {
+  uint8_t start = ssd->dirty_start[page];
+  uint8_t end = ssd->dirty_end[page];
+
+  while (start <= end && ssd->ram_buffer[(start << 3) + page + 1] == ssd->sent_buffer[(start << 3) + page + 1]) {
+    start++;
+  }
+  while (end > start && ssd->ram_buffer[(end << 3) + page + 1] == ssd->sent_buffer[(end << 3) + page + 1]) {
+    end--;
+  }
+
+  if (start > end) {
+    ssd->dirty_start[page] = UINT8_MAX;
+    ssd->dirty_end[page] = 0;
+  } else {
+    ssd->dirty_start[page] = start;
+    ssd->dirty_end[page] = end;
+  }
+}
+
+// Monta em tx_buffer a sequência de transações que leva as regiões alteradas
+// ao display e atualiza sent_buffer. Retorna a quantidade de palavras (0 se
+// não houve alteração).
+static size_t ssd1306_build_transfer(ssd1306_t *ssd) {
+  if (!ssd->full_refresh) {
+    for (uint8_t p = 0; p < ssd->pages; ++p) {
+      if (ssd1306_page_dirty(ssd, p)) {
+        ssd1306_trim_page(ssd, p);
+      }
+    }
+  }
+  ssd->full_refresh = false;
+
+  uint8_t page = 0;
+  size_t len = 0;
+
+  while (page < ssd->pages) {
+    if (!ssd1306_page_dirty(ssd, page)) {
+      page++;
+      continue;
+    }
+
+    // Páginas alteradas consecutivas formam uma única janela (união das colunas)
+    // enquanto isso custar menos bytes que abrir uma nova janela
+    uint8_t first_page = page;
+    uint8_t first_col = ssd->dirty_start[page];
+    uint8_t last_col = ssd->dirty_end[page];
+
+    while (page + 1 < ssd->pages && ssd1306_page_dirty(ssd, page + 1)) {
+      uint8_t next = page + 1;
+      uint8_t start = ssd->dirty_start[next] < first_col ? ssd->dirty_start[next] : first_col;
+      uint8_t end = ssd->dirty_end[next] > last_col ? ssd->dirty_end[next] : last_col;
+      uint16_t pages = next - first_page + 1;
+
+      uint16_t merged = (end - start + 1) * pages;
+      uint16_t separate = (last_col - first_col + 1) * (pages - 1) +
+                          (ssd->dirty_end[next] - ssd->dirty_start[next] + 1) +
+                          SSD1306_WINDOW_OVERHEAD;
+      if (merged > separate) {
+        break;
+      }
+
+      page = next;
+      first_col = start;
+      last_col = end;
     }
+    uint8_t last_page = page;
+
+    // Transação de comandos: janela de colunas e páginas
+    ssd->tx_buffer[len++] = 0x00;
+    ssd->tx_buffer[len++] = SET_COL_ADDR;
+    ssd->tx_buffer[len++] = first_col;
+    ssd->tx_buffer[len++] = last_col;
+    ssd->tx_buffer[len++] = SET_PAGE_ADDR;
+    ssd->tx_buffer[len++] = first_page;
+    ssd->tx_buffer[len++] = last_page | HAL_I2C_STOP;
+
+    // Transação de dados. Endereçamento vertical: para cada coluna, as páginas da janela em sequência
+    ssd->tx_buffer[len++] = 0x40;
+    for (uint16_t x = first_col; x <= last_col; ++x) {
+      const uint8_t *column = &ssd->ram_buffer[(x << 3) + 1];
+      uint8_t *sent = &ssd->sent_buffer[(x << 3) + 1];
+      for (uint8_t p = first_page; p <= last_page; ++p) {
+        ssd->tx_buffer[len++] = sent[p] = column[p];
+      }
+    }
+
+    ssd->tx_buffer[len - 1] |= HAL_I2C_STOP;
+
+    for (uint8_t p = first_page; p <= last_page; ++p) {
+      ssd->dirty_start[p] = UINT8_MAX;
+      ssd->dirty_end[p] = 0;
+    }
+    page++;
+  }
+
+  return len;
+}
+
+static void ssd1306_transfer_done(void *arg) {
+  ssd1306_t *ssd = arg;
+  if (ssd->sent_callback) {
+    ssd->sent_callback(ssd);
+  }
 }
 
+bool ssd1306_busy(ssd1306_t *ssd) {
+  return hal_i2c_busy(ssd->i2c_port);
+}
 
+bool ssd1306_send_data_async(ssd1306_t *ssd) {
+  METRICS_SCOPE(METRICS_SSD1306_SEND_ASYNC);
 
-void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
+  // tx_buffer ainda em uso: as alterações continuam marcadas para o próximo envio
+  if (ssd1306_busy(ssd)) {
+    return false;
+  }
+
+  size_t len = ssd1306_build_transfer(ssd);
+  if (len) {
+    hal_i2c_write_async(ssd->i2c_port, ssd->address, ssd->tx_buffer, len, ssd1306_transfer_done, ssd);
   }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
+  return true;
+}
+
+void ssd1306_send_data(ssd1306_t *ssd) {
+  METRICS_SCOPE(METRICS_SSD1306_SEND);
+
+  while (!ssd1306_send_data_async(ssd)) {
+    hal_sleep_us(100);
+  }
+  while (ssd1306_busy(ssd)) {
+    hal_sleep_us(100);
+  }
+}
+
+// Grava os bits de mask em um byte do buffer (coluna x, página page) e marca a
+// coluna como alterada se o byte mudou. Coordenadas já recortadas pelo chamador.
+static inline void ssd1306_write_bits(ssd1306_t *ssd, uint8_t x, uint8_t page, uint8_t mask, uint8_t bits) {
+  uint8_t *byte = &ssd->ram_buffer[(x << 3) + page + 1];
+  uint8_t value = (*byte & ~mask) | (bits & mask);
+
+  if (value != *byte) {
+    *byte = value;
+    if (x < ssd->dirty_start[page]) ssd->dirty_start[page] = x;
+    if (x > ssd->dirty_end[page]) ssd->dirty_end[page] = x;
+  }
+}
+
+// Preenche as linhas y0..y1 (inclusive) da coluna x, uma página por vez
+static void ssd1306_column_span(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+  uint8_t bits = value ? 0xFF : 0x00;
+  uint8_t first_page = y0 >> 3;
+  uint8_t last_page = y1 >> 3;
+
+  for (uint8_t page = first_page; page <= last_page; ++page) {
+    uint8_t mask = 0xFF;
+    if (page == first_page) mask &= 0xFF << (y0 & 0x07);
+    if (page == last_page) mask &= 0xFF >> (7 - (y1 & 0x07));
+    ssd1306_write_bits(ssd, x, page, mask, bits);
+  }
+}
+
+// Recorta o intervalo [*a, *b] (em qualquer ordem) a [0, limit). Retorna false se ficar vazio.
+static inline bool ssd1306_clip(int *a, int *b, int limit) {
+  if (*a > *b) {
+    int tmp = *a;
+    *a = *b;
+    *b = tmp;
+  }
+  if (*b < 0 || *a >= limit) {
+    return false;
+  }
+  if (*a < 0) *a = 0;
+  if (*b >= limit) *b = limit - 1;
+  return true;
+}
+
+void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+
+  uint8_t bit = 1 << (y & 0b111);
+  ssd1306_write_bits(ssd, x, y >> 3, bit, value ? bit : 0);
+}
+
+void ssd1306_fill(ssd1306_t *ssd, bool value) {
+  // Buffer inteiro byte a byte; as faixas enviadas são reduzidas no envio
+  memset(&ssd->ram_buffer[1], value ? 0xFF : 0x00, ssd->bufsize - 1);
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    ssd->dirty_start[page] = 0;
+    ssd->dirty_end[page] = ssd->width - 1;
   }
+}
+
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+  if (!width || !height)
+    return;
+
+  int right = left + width - 1;
+  int bottom = top + height - 1;
 
   if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+    // Borda e interior têm o mesmo valor: um único preenchimento por coluna
+    int x0 = left, x1 = right, y0 = top, y1 = bottom;
+    if (!ssd1306_clip(&x0, &x1, ssd->width) || !ssd1306_clip(&y0, &y1, ssd->height))
+      return;
+
+    for (int x = x0; x <= x1; ++x)
+      ssd1306_column_span(ssd, x, y0, y1, value);
+    return;
   }
+
+  ssd1306_hline(ssd, left, right > 255 ? 255 : right, top, value);
+  if (bottom <= 255)
+    ssd1306_hline(ssd, left, right > 255 ? 255 : right, bottom, value);
+  ssd1306_vline(ssd, left, top, bottom > 255 ? 255 : bottom, value);
+  if (right <= 255)
+    ssd1306_vline(ssd, right, top, bottom > 255 ? 255 : bottom, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    // Linhas horizontais e verticais (a maior parte do layout) usam os caminhos por byte
+    if (y0 == y1) {
+        ssd1306_hline(ssd, x0, x1, y0, value);
+        return;
+    }
+    if (x0 == x1) {
+        ssd1306_vline(ssd, x0, y0, y1, value);
+        return;
+    }
+
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
 
@@ -144,39 +365,54 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  int start = x0, end = x1;
+  if (y >= ssd->height || !ssd1306_clip(&start, &end, ssd->width))
+    return;
+
+  uint8_t page = y >> 3;
+  uint8_t bit = 1 << (y & 0b111);
+  uint8_t bits = value ? bit : 0;
+  for (int x = start; x <= end; ++x)
+    ssd1306_write_bits(ssd, x, page, bit, bits);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  int start = y0, end = y1;
+  if (x >= ssd->width || !ssd1306_clip(&start, &end, ssd->height))
+    return;
+
+  ssd1306_column_span(ssd, x, start, end, value);
 }
 
 // Função para desenhar um caractere
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
-  uint16_t index = 0;
+  // Caracteres fora da faixa ASCII imprimível são desenhados como espaço (índice 0)
+  uint16_t index = (c >= ' ' && c <= '~') ? (c - ' ') * 8 : 0;
 
-  // Verifica o caractere e calcula o índice correspondente na fonte
-  if (c >= ' ' && c <= '~') // Verifica se o caractere está na faixa ASCII válida
-  {
-    index = (c - ' ') * 8; // Calcula o índice baseado na posição do caractere na tabela ASCII
-  }
-  else
-  {
-    // Caractere inválido, desenha um espaço (ou pode ser tratado de outra forma)
-    index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+
+  // Cada byte da fonte é uma coluna do caractere (bit 0 = linha de cima),
+  // o mesmo formato de uma coluna de página no buffer
+  const uint8_t *glyph = &font[index];
+  uint8_t columns = (ssd->width - x) < 8 ? (ssd->width - x) : 8;
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 0b111;
+
+  if (!shift) {
+    // Alinhado à página: um byte por coluna
+    for (uint8_t i = 0; i < columns; ++i)
+      ssd1306_write_bits(ssd, x + i, page, 0xFF, glyph[i]);
+    return;
   }
 
-  // Desenha o caractere na tela
-  for (uint8_t i = 0; i < 8; ++i)
-  {
-    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
-    }
+  // Desalinhado: cada coluna se divide entre duas páginas
+  bool has_next_page = page + 1 < ssd->pages;
+  for (uint8_t i = 0; i < columns; ++i) {
+    ssd1306_write_bits(ssd, x + i, page, 0xFF << shift, glyph[i] << shift);
+    if (has_next_page)
+      ssd1306_write_bits(ssd, x + i, page + 1, 0xFF >> (8 - shift), glyph[i] >> (8 - shift));
   }
 }
 
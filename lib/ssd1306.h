@@ -1,10 +1,27 @@
-#include <stdlib.h>
-#include "pico/stdlib.h"
-#include "hardware/i2c.h"
+#ifndef SSD1306_H
+#define SSD1306_H
+
+#include <stddef.h>
+#include "hal/hal.h"
 
 #define WIDTH 128
 #define HEIGHT 64
 
+// Quantidade máxima de páginas (8 linhas cada) acompanhadas pelo controle de regiões alteradas
+#define SSD1306_MAX_PAGES 8
+
+// Maior display suportado. Os buffers ficam dentro de ssd1306_t (sem heap),
+// dimensionados para ele.
+#define SSD1306_MAX_WIDTH 128
+
+// Quadro completo mais o byte de controle (0x40) da transação de dados
+#define SSD1306_BUFSIZE_MAX (SSD1306_MAX_PAGES * SSD1306_MAX_WIDTH + 1)
+
+// Palavras da sequência de transferência usadas pela transação de comandos de uma janela
+#define SSD1306_WINDOW_COMMAND_WORDS 7
+
+#define SSD1306_TX_LEN_MAX (SSD1306_BUFSIZE_MAX + SSD1306_MAX_PAGES * SSD1306_WINDOW_COMMAND_WORDS)
+
 typedef enum {
   SET_CONTRAST = 0x81,
   SET_ENTIRE_ON = 0xA4,
@@ -25,20 +42,50 @@ typedef enum {
   SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t;
 
-typedef struct {
+typedef struct ssd1306 ssd1306_t;
+
+// Chamado (em interrupção, no Pico) quando a transferência assíncrona termina
+typedef void (*ssd1306_callback_t)(ssd1306_t *ssd);
+
+struct ssd1306 {
   uint8_t width, height, pages, address;
-  i2c_inst_t *i2c_port;
+  hal_i2c_port_t i2c_port;
   bool external_vcc;
-  uint8_t *ram_buffer;
+  uint8_t ram_buffer[SSD1306_BUFSIZE_MAX];
+  uint16_t tx_buffer[SSD1306_TX_LEN_MAX];  // transações em envio (byte + HAL_I2C_STOP); independente de ram_buffer
+  size_t tx_len;                           // capacidade usada de tx_buffer (palavras)
+  uint8_t sent_buffer[SSD1306_BUFSIZE_MAX]; // cópia do que já foi enviado à GDDRAM do display
   size_t bufsize;
   uint8_t port_buffer[2];
-} ssd1306_t;
+  // Faixa de colunas alterada em cada página desde o último envio (início > fim => página limpa)
+  uint8_t dirty_start[SSD1306_MAX_PAGES];
+  uint8_t dirty_end[SSD1306_MAX_PAGES];
+  bool full_refresh;    // envia as faixas marcadas sem compará-las com sent_buffer
+  ssd1306_callback_t sent_callback;
+};
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
+// Displays maiores que SSD1306_MAX_WIDTH x (8 * SSD1306_MAX_PAGES) são limitados a esse tamanho
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, hal_i2c_port_t i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t len);
+
+// Envia apenas as regiões alteradas desde o último envio (nada, se não houve alteração)
+// e aguarda o fim da transferência
 void ssd1306_send_data(ssd1306_t *ssd);
 
+// Inicia o envio das regiões alteradas por DMA e retorna imediatamente. As
+// regiões são copiadas para tx_buffer, então ram_buffer pode ser redesenhado
+// durante a transferência. Retorna false (sem enviar nada) se a transferência
+// anterior ainda não terminou; as alterações seguem pendentes.
+bool ssd1306_send_data_async(ssd1306_t *ssd);
+
+// Indica se ainda há uma transferência em andamento
+bool ssd1306_busy(ssd1306_t *ssd);
+
+// Marca o display inteiro como alterado, forçando o envio completo no próximo ssd1306_send_data
+void ssd1306_invalidate(ssd1306_t *ssd);
+
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
@@ -47,3 +94,5 @@ void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
+#endif // SSD1306_H
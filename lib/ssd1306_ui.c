@@ -0,0 +1,59 @@
+#include <string.h>
+
+#include "ssd1306_ui.h"
+
+void ssd1306_scene_init(ssd1306_scene_t *scene, ssd1306_t *ssd, ssd1306_ui_draw_t background,
+                        ssd1306_text_field_t *fields, uint8_t field_count) {
+  scene->ssd = ssd;
+  scene->background = background;
+  scene->fields = fields;
+  scene->field_count = field_count;
+  ssd1306_scene_invalidate(scene);
+}
+
+void ssd1306_text_field_set(ssd1306_text_field_t *field, const char *text) {
+  // Texto limitado à largura do campo
+  size_t max = field->max_chars < SSD1306_UI_TEXT_MAX ? field->max_chars : SSD1306_UI_TEXT_MAX;
+
+  char truncated[SSD1306_UI_TEXT_MAX + 1];
+
+  strncpy(truncated, text, max);
+  truncated[max] = '\0';
+  if (strcmp(truncated, field->text) == 0) {
+    return;
+  }
+
+  memcpy(field->text, truncated, sizeof(truncated));
+  field->changed = true;
+}
+
+void ssd1306_scene_invalidate(ssd1306_scene_t *scene) {
+  scene->background_drawn = false;
+  for (uint8_t i = 0; i < scene->field_count; i++) {
+    scene->fields[i].changed = true;
+  }
+}
+
+void ssd1306_scene_render(ssd1306_scene_t *scene) {
+  ssd1306_t *ssd = scene->ssd;
+
+  if (!scene->background_drawn) {
+    ssd1306_fill(ssd, false);
+    if (scene->background) {
+      scene->background(ssd);
+    }
+    scene->background_drawn = true;
+  }
+
+  for (uint8_t i = 0; i < scene->field_count; i++) {
+    ssd1306_text_field_t *field = &scene->fields[i];
+    if (!field->changed) {
+      continue;
+    }
+
+    // Limpa apenas a área do campo e desenha o novo texto
+    ssd1306_rect(ssd, field->y, field->x, field->max_chars * 8, 8, false, true);
+    ssd1306_draw_string(ssd, field->text, field->x, field->y);
+    field->changed = false;
+  }
+}
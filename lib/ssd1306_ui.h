@@ -0,0 +1,49 @@
+#ifndef SSD1306_UI_H
+#define SSD1306_UI_H
+
+/*
+ * Camada de interface em modo retido sobre o driver SSD1306.
+ *
+ * Uma cena tem um fundo estático (desenhado uma única vez) e campos de texto.
+ * Cada campo guarda o texto exibido e só é redesenhado, dentro da sua própria
+ * área, quando o conteúdo muda. Junto com o envio apenas das regiões
+ * alteradas, uma tela sem mudanças não custa nenhuma operação de desenho nem
+ * bytes no I2C.
+ */
+
+#include "lib/ssd1306.h"
+
+// Tamanho máximo do texto de um campo (sem o terminador)
+#define SSD1306_UI_TEXT_MAX 15
+
+typedef struct {
+  uint8_t x, y;       // canto superior esquerdo
+  uint8_t max_chars;  // largura do campo em caracteres de 8x8 pixels
+  char text[SSD1306_UI_TEXT_MAX + 1];
+  bool changed;
+} ssd1306_text_field_t;
+
+// Desenha o conteúdo fixo da cena (sobre a tela já limpa)
+typedef void (*ssd1306_ui_draw_t)(ssd1306_t *ssd);
+
+typedef struct {
+  ssd1306_t *ssd;
+  ssd1306_ui_draw_t background;
+  ssd1306_text_field_t *fields;
+  uint8_t field_count;
+  bool background_drawn;
+} ssd1306_scene_t;
+
+void ssd1306_scene_init(ssd1306_scene_t *scene, ssd1306_t *ssd, ssd1306_ui_draw_t background,
+                        ssd1306_text_field_t *fields, uint8_t field_count);
+
+// Altera o texto do campo. Não faz nada se o texto for igual ao exibido.
+void ssd1306_text_field_set(ssd1306_text_field_t *field, const char *text);
+
+// Redesenha no buffer apenas o que mudou (o envio ao display fica a cargo do chamador)
+void ssd1306_scene_render(ssd1306_scene_t *scene);
+
+// Força o redesenho completo (fundo e todos os campos) no próximo render
+void ssd1306_scene_invalidate(ssd1306_scene_t *scene);
+
+#endif // SSD1306_UI_H
@@ -14,6 +14,9 @@
 #define MEMP_NUM_UDP_PCB 4
 #define MEMP_NUM_TCP_PCB 4
 #define MEMP_NUM_TCP_SEG 16
+#define TCP_MSS 1460
+#define TCP_SND_BUF (2 * TCP_MSS)       // Comporta a resposta HTTP inteira em um único tcp_write
+#define TCP_WND (2 * TCP_MSS)
 #define LWIP_IPV4 1
 #define LWIP_ICMP 1
 #define LWIP_RAW 1
@@ -28,5 +31,17 @@
 #define LWIP_HTTPD_CGI 0           // Desative CGI para economizar memória
 #define LWIP_NETIF_HOSTNAME 1
 
+// Estatísticas de uso dos pools e do heap, publicadas em /metrics (src/metrics.h)
+#if METRICS_ENABLED
+#define LWIP_STATS 1
+#define MEM_STATS 1
+#define MEMP_STATS 1
+#define TCP_STATS 1
+#define UDP_STATS 1
+#else
+#define LWIP_STATS 0
+#endif
+#define LWIP_STATS_DISPLAY 0
+
 
 #endif /* LWIPOPTS_H */
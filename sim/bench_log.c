@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal/hal.h"
+#include "src/flash_log.h"
+
+// Formato e vazão do registro na flash (src/flash_log.h) sobre a flash
+// simulada. Com SIM_FLASH=<arquivo> o registro fica em um arquivo mapeado em
+// memória e pode ser reaberto entre execuções.
+//
+// Acrescenta medições de uma triagem simulada (um resistor E24 a cada ~2 s,
+// com pequenas variações entre leituras), dando várias voltas na área do
+// registro, e confere a leitura de volta das páginas que restaram.
+//
+// Observação: no host a gravação e o apagamento são cópias em memória; no
+// RP2040 a gravação de uma página leva ~1 ms e o apagamento de um setor
+// dezenas de ms, ambos com os dois núcleos fora da flash.
+
+#define BENCH_RECORDS 200000
+
+static const uint16_t bench_e24[] = {10, 11, 12, 13, 15, 16, 18, 20, 22, 24, 27, 30, 33, 36, 39, 43, 47, 51, 56, 62, 68, 75, 82, 91};
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_measurement(uint32_t i, measurement_t *m) {
+  static uint32_t timestamp_ms = 0;
+  static uint32_t nominal = 0;
+
+  // Um resistor novo a cada 8 leituras; as demais variam ~0,5%
+  if (i % 8 == 0) {
+    uint32_t decade = 1;
+    for (int d = rand() % 5; d > 0; d--) {
+      decade *= 10;
+    }
+    nominal = bench_e24[rand() % 24] * decade;
+    timestamp_ms += 1500 + rand() % 1000;
+  } else {
+    timestamp_ms += 100 + rand() % 200;
+  }
+
+  memset(m, 0, sizeof(*m));
+  m->timestamp_ms = timestamp_ms;
+  m->measured = ohms_q8_from_int(nominal) + (ohms_q8_t)((int64_t)ohms_q8_from_int(nominal) * (rand() % 11 - 5) / 1000);
+}
+
+static uint32_t bench_get_varint(const uint8_t *data, uint32_t *v) {
+  uint32_t value = 0;
+  uint32_t len = 0;
+  uint8_t byte;
+
+  do {
+    byte = data[len];
+    value |= (uint32_t)(byte & 0x7Fu) << (7 * len);
+    len++;
+  } while ((byte & 0x80u) && len < 5);
+
+  *v = value;
+  return len;
+}
+
+// Decodifica uma página, conferindo cada registro com a medição gerada
+static uint32_t bench_check_page(const uint8_t *page, const measurement_t *expected, uint32_t *bad) {
+  flash_log_page_t header;
+  memcpy(&header, page, sizeof(header));
+
+  uint32_t timestamp_ms = header.timestamp_ms;
+  ohms_q8_t measured = header.measured;
+  const uint8_t *records = page + sizeof(header);
+  uint32_t pos = 0;
+
+  for (uint32_t i = 0; i < header.count; i++) {
+    if (i) {
+      uint32_t dt;
+      uint32_t dm;
+      pos += bench_get_varint(records + pos, &dt);
+      pos += bench_get_varint(records + pos, &dm);
+      timestamp_ms += dt;
+      measured += (uint32_t)((int32_t)(dm >> 1) ^ -(int32_t)(dm & 1u));
+    }
+    if (expected && (expected[i].timestamp_ms != timestamp_ms || expected[i].measured != measured)) {
+      (*bad)++;
+    }
+  }
+  if (pos != header.used) {
+    (*bad)++;
+  }
+  return header.count;
+}
+
+int main(void) {
+  static measurement_t generated[BENCH_RECORDS];
+
+  srand(1);
+  flash_log_init();
+
+  uint32_t first;
+  uint32_t end;
+  flash_log_range(&first, &end);
+  uint32_t start_seq = end;
+
+  uint64_t worst = 0;
+  uint64_t ns0 = bench_ns();
+  for (uint32_t i = 0; i < BENCH_RECORDS; i++) {
+    bench_measurement(i, &generated[i]);
+
+    uint64_t t0 = bench_ns();
+    flash_log_append(&generated[i]);
+    uint64_t t = bench_ns() - t0;
+    if (t > worst) {
+      worst = t;
+    }
+  }
+  flash_log_flush();
+  uint64_t ns1 = bench_ns();
+
+  flash_log_range(&first, &end);
+  uint32_t pages = end - start_seq;
+
+  printf("registros: %d em %lu páginas (%lu setores apagados)\n", BENCH_RECORDS,
+         (unsigned long)pages, (unsigned long)(pages / FLASH_LOG_SECTOR_PAGES));
+  printf("registros por página: %.1f  bytes por registro: %.2f\n",
+         (double)BENCH_RECORDS / pages, (double)pages * HAL_FLASH_PAGE_SIZE / BENCH_RECORDS);
+  printf("acréscimo: %.1f ns em média, pior caso %.1f us (com gravação de página)\n",
+         (double)(ns1 - ns0) / BENCH_RECORDS, (double)worst / 1000.0);
+  printf("capacidade: %u páginas, ~%.0f registros\n", (unsigned)FLASH_LOG_PAGES,
+         (double)FLASH_LOG_PAGES * BENCH_RECORDS / pages);
+
+  // Leitura de volta: as páginas mais recentes correspondem ao fim das medições geradas
+  static uint8_t page[HAL_FLASH_PAGE_SIZE];
+  uint32_t available = 0;
+  uint32_t records = 0;
+  uint32_t bad = 0;
+  uint32_t total = 0;
+
+  uint64_t ns2 = bench_ns();
+  for (uint32_t seq = first; seq != end; seq++) {
+    if (flash_log_read_page(seq, page)) {
+      available++;
+      records += bench_check_page(page, NULL, &bad);
+    }
+  }
+  uint64_t ns3 = bench_ns();
+
+  uint32_t index = BENCH_RECORDS - records;
+  for (uint32_t seq = first; seq != end; seq++) {
+    if (flash_log_read_page(seq, page) && (int32_t)(seq - start_seq) >= 0) {
+      total += bench_check_page(page, &generated[index], &bad);
+      index += ((flash_log_page_t *)page)->count;
+    }
+  }
+
+  printf("leitura: %lu páginas de %lu (%lu registros, %.1f us por página), %lu registros com erro\n",
+         (unsigned long)available, (unsigned long)(end - first), (unsigned long)records,
+         (double)(ns3 - ns2) / 1000.0 / (available ? available : 1), (unsigned long)bad);
+
+  // Reabertura: a varredura inicial deve encontrar as mesmas páginas
+  uint32_t reopened_first;
+  uint32_t reopened_end;
+  flash_log_init();
+  flash_log_range(&reopened_first, &reopened_end);
+  bool reopened = reopened_first == first && reopened_end == end;
+  printf("reabertura: %s\n", reopened ? "ok" : "divergente");
+
+  return bad || !reopened || total != records;
+}
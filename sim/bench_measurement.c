@@ -0,0 +1,182 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "hal/hal.h"
+#include "sim/sim.h"
+#include "src/e_series.h"
+#include "src/resistor.h"
+
+// Compara o custo por leitura do caminho em ponto flutuante (implementação
+// anterior) com o caminho em ponto fixo: média, equação do divisor e busca do
+// valor comercial com cores das bandas.
+//
+// Observação: o host tem FPU, então a diferença aqui subestima a do RP2040,
+// onde cada operação float é uma chamada à biblioteca de soft-float.
+
+#define BENCH_SAMPLES 1000
+#define BENCH_READINGS 20000
+#define BENCH_RANGE 1 // faixa de 3,3 kΩ
+
+// Ambos os caminhos usam a mesma referência
+static float float_reference;
+
+// ------------------------ Caminho anterior (float) ---------------------------
+
+static const float float_e24_values[24] = {1.0, 1.1, 1.2, 1.3, 1.5, 1.6, 1.8, 2.0, 2.2, 2.4, 2.7, 3.0, 3.3, 3.6, 3.9, 4.3, 4.7, 5.1, 5.6, 6.2, 6.8, 7.5, 8.2, 9.1};
+
+static float float_closest_e24(float resistor_value) {
+  if (resistor_value <= 0) {
+    return 0.0f;
+  }
+
+  float normalized = resistor_value;
+  float exponent = 0.0f;
+  while (normalized >= 10) {
+    normalized = normalized / 10;
+    exponent = exponent + 1.0f;
+  }
+
+  float closest = float_e24_values[0];
+  float min_diff = fabsf(normalized - float_e24_values[0]);
+  for (int i = 0; i < 24; i++) {
+    float diff = fabsf(normalized - float_e24_values[i]);
+    if (diff < min_diff) {
+      min_diff = diff;
+      closest = float_e24_values[i];
+    }
+  }
+  return closest * powf(10.0f, exponent);
+}
+
+static void float_band_color(float resistor_value, int8_t bands[3]) {
+  float normalized = resistor_value;
+  int exponent = -1;
+  while (normalized >= 10.0f) {
+    normalized = normalized / 10;
+    exponent = exponent + 1;
+  }
+  bands[0] = (int)normalized % 10;
+  bands[1] = (int)(normalized * 10) % 10;
+  bands[2] = (exponent >= 0 && exponent <= 9) ? exponent : -1;
+}
+
+static float float_reading(const uint16_t *samples, uint32_t count, int8_t bands[3]) {
+  float cumulative = 0.0f;
+  for (uint32_t i = 0; i < count; i++) {
+    cumulative += samples[i];
+  }
+  float average = cumulative / (float)count;
+  float measured = (float_reference * average) / ((float)HAL_ADC_MAX_VALUE - average);
+  float commercial = float_closest_e24(measured);
+  float_band_color(commercial, bands);
+  return commercial;
+}
+
+// ------------------------ Caminho atual (ponto fixo) -------------------------
+
+static ohms_q8_t fixed_reading(const uint16_t *samples, uint32_t count, e_series_match_t *match) {
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    sum += samples[i];
+  }
+  ohms_q8_t measured = resistor_from_adc_sum(&resistor_ranges[BENCH_RANGE], sum, count);
+  e_series_nearest(E_SERIES_E24, measured, match);
+  return match->value;
+}
+
+// -----------------------------------------------------------------------------
+
+static uint64_t bench_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+int main(void) {
+  static const float unknowns[] = {10.0f, 47.0f, 330.0f, 998.9f, 2200.0f, 4700.0f, 68000.0f};
+  const int unknown_count = sizeof(unknowns) / sizeof(unknowns[0]);
+  static uint16_t samples[sizeof(unknowns) / sizeof(unknowns[0])][BENCH_SAMPLES];
+
+  resistor_select_range(BENCH_RANGE);
+  float_reference = (float)resistor_ranges[BENCH_RANGE].reference / OHMS_Q8_ONE;
+
+  for (int u = 0; u < unknown_count; u++) {
+    sim_adc_set_unknown(unknowns[u]);
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+      samples[u][i] = sim_adc_sample(RESISTOR_ADC_INPUT);
+    }
+  }
+
+  volatile float float_sink = 0.0f;
+  volatile ohms_q8_t fixed_sink = 0;
+  int8_t bands[3];
+  e_series_match_t match;
+
+  uint64_t ns0 = bench_ns(), c0 = bench_cycles();
+  for (int r = 0; r < BENCH_READINGS; r++) {
+    float_sink = float_reading(samples[r % unknown_count], BENCH_SAMPLES, bands);
+  }
+  uint64_t ns1 = bench_ns(), c1 = bench_cycles();
+  for (int r = 0; r < BENCH_READINGS; r++) {
+    fixed_sink = fixed_reading(samples[r % unknown_count], BENCH_SAMPLES, &match);
+  }
+  uint64_t ns2 = bench_ns(), c2 = bench_cycles();
+
+  // Só a conversão (equação do divisor + série E + bandas), sem o laço de soma
+  uint32_t sums[sizeof(unknowns) / sizeof(unknowns[0])];
+  for (int u = 0; u < unknown_count; u++) {
+    sums[u] = 0;
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+      sums[u] += samples[u][i];
+    }
+  }
+
+  uint64_t ns3 = bench_ns(), c3 = bench_cycles();
+  for (int r = 0; r < BENCH_READINGS * 10; r++) {
+    float average = (float)sums[r % unknown_count] / (float)BENCH_SAMPLES;
+    float measured = (float_reference * average) / ((float)HAL_ADC_MAX_VALUE - average);
+    float commercial = float_closest_e24(measured);
+    float_band_color(commercial, bands);
+    float_sink = commercial;
+  }
+  uint64_t ns4 = bench_ns(), c4 = bench_cycles();
+  for (int r = 0; r < BENCH_READINGS * 10; r++) {
+    e_series_nearest(E_SERIES_E24, resistor_from_adc_sum(&resistor_ranges[BENCH_RANGE], sums[r % unknown_count], BENCH_SAMPLES), &match);
+    fixed_sink = match.value;
+  }
+  uint64_t ns5 = bench_ns(), c5 = bench_cycles();
+  (void)float_sink;
+  (void)fixed_sink;
+
+  printf("leituras: %d x %d amostras\n", BENCH_READINGS, BENCH_SAMPLES);
+  printf("%-12s %12s %12s\n", "caminho", "ns/leitura", "ciclos/leit.");
+  printf("%-12s %12.1f %12.0f\n", "float", (double)(ns1 - ns0) / BENCH_READINGS, (double)(c1 - c0) / BENCH_READINGS);
+  printf("%-12s %12.1f %12.0f\n", "ponto fixo", (double)(ns2 - ns1) / BENCH_READINGS, (double)(c2 - c1) / BENCH_READINGS);
+  printf("somente a conversão (sem o laço de soma):\n");
+  printf("%-12s %12.1f %12.0f\n", "float", (double)(ns4 - ns3) / (BENCH_READINGS * 10), (double)(c4 - c3) / (BENCH_READINGS * 10));
+  printf("%-12s %12.1f %12.0f\n", "ponto fixo", (double)(ns5 - ns4) / (BENCH_READINGS * 10), (double)(c5 - c4) / (BENCH_READINGS * 10));
+
+  // Conferência: mesmo valor comercial nos dois caminhos (exceto onde o
+  // caminho float errava por comparar diferenças absolutas)
+  for (int u = 0; u < unknown_count; u++) {
+    float commercial = float_reading(samples[u], BENCH_SAMPLES, bands);
+    fixed_reading(samples[u], BENCH_SAMPLES, &match);
+    printf("  %8.1f ohms: float %8.0f  ponto fixo %8lu\n", unknowns[u], commercial,
+           (unsigned long)ohms_q8_round(match.value));
+  }
+  return 0;
+}
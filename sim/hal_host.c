@@ -0,0 +1,480 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hal/hal.h"
+#include "sim/sim.h"
+
+// Implementação da HAL para o simulador em Linux.
+//
+// A pilha de rede é atendida em hal_net_poll() e também durante hal_sleep_* e
+// hal_event_wait() no núcleo 0, imitando o modo
+// pico_cyw43_arch_lwip_threadsafe_background do firmware, em que o lwIP
+// continua processando pacotes enquanto o laço principal dorme.
+// O núcleo 1 é uma thread separada; ela nunca toca no lwIP emulado.
+
+#define SIM_GPIO_COUNT 30
+
+static uint64_t boot_time_us = 0;
+static bool gpio_state[SIM_GPIO_COUNT];
+static bool gpio_output[SIM_GPIO_COUNT];
+static uint32_t gpio_irq_events[SIM_GPIO_COUNT];
+static hal_gpio_irq_callback_t gpio_irq_callback = NULL;
+static uint32_t i2c_baudrate[2];
+static const char *oled_pbm_path = NULL;
+static uint8_t *flash_data = NULL;
+static __thread bool is_core1 = false;
+
+static uint64_t hal_host_monotonic_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+// ---------------------------------- Sistema ----------------------------------
+
+void hal_stdio_init(void) {
+  setvbuf(stdout, NULL, _IOLBF, 0);
+  oled_pbm_path = getenv("SIM_OLED_PBM");
+}
+
+void hal_reset_to_bootloader(void) {
+  printf("sim: reset para o modo BOOTSEL, encerrando\n");
+  exit(0);
+}
+
+// ---------------------------------- Tempo ------------------------------------
+
+uint32_t hal_time_ms(void) {
+  return (uint32_t)(hal_time_us() / 1000u);
+}
+
+uint64_t hal_time_us(void) {
+  if (!boot_time_us) {
+    boot_time_us = hal_host_monotonic_us();
+  }
+  return hal_host_monotonic_us() - boot_time_us;
+}
+
+void hal_sleep_us(uint64_t us) {
+  uint64_t deadline = hal_time_us() + us;
+
+  // Esperas curtas (menos de 1 ms) e as do núcleo 1 não atendem a rede
+  if (us < 1000u || is_core1) {
+    struct timespec ts = { .tv_sec = (time_t)(us / 1000000u), .tv_nsec = (long)(us % 1000000u) * 1000 };
+    nanosleep(&ts, NULL);
+    return;
+  }
+
+  uint64_t now;
+  while ((now = hal_time_us()) < deadline) {
+    sim_lwip_poll((int)((deadline - now + 999u) / 1000u));
+  }
+}
+
+uint32_t hal_timer_us32(void) {
+  return (uint32_t)hal_time_us();
+}
+
+void hal_sleep_ms(uint32_t ms) {
+  hal_sleep_us((uint64_t)ms * 1000u);
+}
+
+// Prazo absoluto (CLOCK_REALTIME, o relógio de pthread_cond_timedwait) daqui a us microssegundos
+static struct timespec hal_host_deadline(uint64_t us) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  uint64_t nsec = (uint64_t)ts.tv_nsec + (us % 1000000u) * 1000u;
+  ts.tv_sec += (time_t)(us / 1000000u + nsec / 1000000000u);
+  ts.tv_nsec = (long)(nsec % 1000000000u);
+  return ts;
+}
+
+// --------------------------------- Eventos -----------------------------------
+
+// O registrador de evento do WFE é imitado por um contador global: cada
+// thread guarda o último valor visto e a espera retorna assim que ele muda.
+static pthread_mutex_t event_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t event_cond = PTHREAD_COND_INITIALIZER;
+static uint32_t event_count = 0;
+static __thread uint32_t event_seen = 0;
+
+void hal_event_signal(void) {
+  pthread_mutex_lock(&event_mutex);
+  __atomic_add_fetch(&event_count, 1, __ATOMIC_SEQ_CST);
+  pthread_cond_broadcast(&event_cond);
+  pthread_mutex_unlock(&event_mutex);
+
+  // Interrompe a espera do núcleo 0 nos sockets
+  sim_lwip_wake();
+}
+
+void hal_event_wait(uint32_t timeout_us) {
+  if (is_core1) {
+    struct timespec deadline = hal_host_deadline(timeout_us);
+    pthread_mutex_lock(&event_mutex);
+    if (event_count == event_seen) {
+      pthread_cond_timedwait(&event_cond, &event_mutex, &deadline);
+    }
+    pthread_mutex_unlock(&event_mutex);
+  } else {
+    // O núcleo 0 atende a rede enquanto espera, como no modo threadsafe_background
+    uint64_t deadline = hal_time_us() + timeout_us;
+    uint64_t now;
+    while (__atomic_load_n(&event_count, __ATOMIC_SEQ_CST) == event_seen && (now = hal_time_us()) < deadline) {
+      sim_lwip_poll((int)((deadline - now + 999u) / 1000u));
+    }
+  }
+  event_seen = __atomic_load_n(&event_count, __ATOMIC_SEQ_CST);
+}
+
+// -------------------------------- Multinúcleo --------------------------------
+
+static void *hal_core1_thread(void *entry) {
+  is_core1 = true;
+  ((void (*)(void))entry)();
+  return NULL;
+}
+
+void hal_core1_launch(void (*entry)(void)) {
+  pthread_t thread;
+  if (pthread_create(&thread, NULL, hal_core1_thread, (void *)entry) != 0) {
+    printf("sim: falha ao criar a thread do núcleo 1\n");
+    exit(1);
+  }
+  pthread_detach(thread);
+}
+
+void hal_memory_barrier(void) {
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+// --------------------------------- GPIO / IRQ --------------------------------
+
+void hal_gpio_init_input_pullup(uint gpio) {
+  if (gpio < SIM_GPIO_COUNT) {
+    gpio_state[gpio] = true;
+    gpio_output[gpio] = false;
+  }
+}
+
+void hal_gpio_init_output(uint gpio) {
+  if (gpio < SIM_GPIO_COUNT) {
+    gpio_state[gpio] = false;
+    gpio_output[gpio] = true;
+  }
+}
+
+void hal_gpio_init_input(uint gpio) {
+  if (gpio < SIM_GPIO_COUNT) {
+    gpio_state[gpio] = false;
+    gpio_output[gpio] = false;
+  }
+}
+
+void hal_gpio_put(uint gpio, bool value) {
+  if (gpio < SIM_GPIO_COUNT) {
+    gpio_state[gpio] = value;
+  }
+}
+
+bool hal_gpio_get(uint gpio) {
+  return gpio < SIM_GPIO_COUNT ? gpio_state[gpio] : false;
+}
+
+void hal_gpio_set_irq(uint gpio, uint32_t events, hal_gpio_irq_callback_t callback) {
+  gpio_irq_callback = callback;
+  if (gpio < SIM_GPIO_COUNT) {
+    gpio_irq_events[gpio] = events;
+  }
+}
+
+int sim_gpio_output_level(unsigned gpio) {
+  if (gpio >= SIM_GPIO_COUNT || !gpio_output[gpio]) {
+    return -1;
+  }
+  return gpio_state[gpio];
+}
+
+void sim_gpio_trigger(unsigned gpio, bool level) {
+  if (gpio >= SIM_GPIO_COUNT || gpio_state[gpio] == level) {
+    return;
+  }
+  gpio_state[gpio] = level;
+
+  uint32_t event = level ? HAL_GPIO_IRQ_EDGE_RISE : HAL_GPIO_IRQ_EDGE_FALL;
+  if (gpio_irq_callback && (gpio_irq_events[gpio] & event)) {
+    gpio_irq_callback(gpio, event);
+  }
+}
+
+// ----------------------------------- ADC -------------------------------------
+
+static uint adc_input = 0;
+
+void hal_adc_init(uint gpio) {
+  (void)gpio;
+}
+
+void hal_adc_select_input(uint input) {
+  adc_input = input;
+}
+
+uint16_t hal_adc_read(void) {
+  return sim_adc_sample(adc_input);
+}
+
+// Aquisição contínua simulada: as amostras que o DMA teria gravado desde a
+// última consulta são geradas sob demanda, a partir do tempo decorrido.
+static volatile uint16_t *adc_ring = NULL;
+static uint32_t adc_ring_mask = 0;
+static uint32_t adc_stream_rate = 0;
+static uint64_t adc_stream_start_us = 0;
+static uint64_t adc_stream_produced = 0;
+
+// Interrupção de fim de bloco do DMA: uma thread chama o callback nos
+// instantes em que cada bloco estaria completo
+static hal_adc_callback_t adc_callback = NULL;
+static void *adc_callback_arg = NULL;
+static uint32_t adc_block_samples = 0;
+static pthread_t adc_dma_thread;
+static pthread_mutex_t adc_dma_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t adc_dma_cond = PTHREAD_COND_INITIALIZER;
+static bool adc_dma_active = false;
+
+static void *hal_adc_dma_thread(void *unused) {
+  (void)unused;
+  uint64_t block = 1;
+
+  pthread_mutex_lock(&adc_dma_mutex);
+  while (adc_dma_active) {
+    uint64_t due_us = adc_stream_start_us + block * adc_block_samples * 1000000u / adc_stream_rate;
+    uint64_t now = hal_time_us();
+
+    if (now < due_us) {
+      struct timespec deadline = hal_host_deadline(due_us - now);
+      pthread_cond_timedwait(&adc_dma_cond, &adc_dma_mutex, &deadline);
+      continue;
+    }
+
+    block++;
+    pthread_mutex_unlock(&adc_dma_mutex);
+    adc_callback(adc_callback_arg);
+    pthread_mutex_lock(&adc_dma_mutex);
+  }
+  pthread_mutex_unlock(&adc_dma_mutex);
+  return NULL;
+}
+
+bool hal_adc_stream_start(uint input, uint32_t sample_rate_hz, volatile uint16_t *ring, uint8_t ring_bits,
+                          uint8_t block_bits, hal_adc_callback_t callback, void *arg) {
+  if (adc_ring || !sample_rate_hz || block_bits > ring_bits) {
+    return false;
+  }
+
+  adc_input = input;
+  adc_ring = ring;
+  adc_ring_mask = (1u << ring_bits) - 1;
+  adc_stream_rate = sample_rate_hz;
+  adc_stream_start_us = hal_time_us();
+  adc_stream_produced = 0;
+
+  if (callback) {
+    adc_callback = callback;
+    adc_callback_arg = arg;
+    adc_block_samples = 1u << block_bits;
+    adc_dma_active = true;
+    if (pthread_create(&adc_dma_thread, NULL, hal_adc_dma_thread, NULL) != 0) {
+      adc_dma_active = false;
+    }
+  }
+  return true;
+}
+
+void hal_adc_stream_stop(void) {
+  if (adc_dma_active) {
+    pthread_mutex_lock(&adc_dma_mutex);
+    adc_dma_active = false;
+    pthread_cond_signal(&adc_dma_cond);
+    pthread_mutex_unlock(&adc_dma_mutex);
+    pthread_join(adc_dma_thread, NULL);
+  }
+  adc_ring = NULL;
+}
+
+uint32_t hal_adc_stream_write_index(void) {
+  if (!adc_ring) {
+    return 0;
+  }
+
+  uint64_t expected = (hal_time_us() - adc_stream_start_us) * adc_stream_rate / 1000000u;
+
+  // Mais de uma volta sem consulta: só a última volta do buffer importa
+  if (expected - adc_stream_produced > adc_ring_mask) {
+    adc_stream_produced = expected - adc_ring_mask;
+  }
+
+  for (; adc_stream_produced < expected; adc_stream_produced++) {
+    adc_ring[adc_stream_produced & adc_ring_mask] = sim_adc_sample(adc_input);
+  }
+  return (uint32_t)(adc_stream_produced & adc_ring_mask);
+}
+
+// ----------------------------------- I2C -------------------------------------
+
+void hal_i2c_init(hal_i2c_port_t port, uint32_t baudrate, uint sda, uint scl) {
+  (void)sda;
+  (void)scl;
+  i2c_baudrate[port & 0x01] = baudrate;
+}
+
+int hal_i2c_write(hal_i2c_port_t port, uint8_t address, const uint8_t *src, size_t len, bool nostop) {
+  (void)nostop;
+  sim_oled_i2c_write(address, src, len, i2c_baudrate[port & 0x01]);
+
+  // Atualiza a imagem do display sempre que um quadro de dados é recebido
+  if (oled_pbm_path && len > 1 && src[0] == 0x40) {
+    sim_oled_write_pbm(oled_pbm_path);
+  }
+  return (int)len;
+}
+
+bool hal_i2c_write_async(hal_i2c_port_t port, uint8_t address, const uint16_t *src, size_t len,
+                         hal_i2c_callback_t callback, void *arg) {
+  uint8_t transaction[1100];
+  size_t count = 0;
+
+  // Divide a sequência nas transações delimitadas por HAL_I2C_STOP
+  for (size_t i = 0; i < len; i++) {
+    if (count < sizeof(transaction)) {
+      transaction[count++] = (uint8_t)src[i];
+    }
+    if ((src[i] & HAL_I2C_STOP) || i + 1 == len) {
+      hal_i2c_write(port, address, transaction, count, false);
+      count = 0;
+    }
+  }
+
+  if (callback) {
+    callback(arg);
+  }
+  return true;
+}
+
+bool hal_i2c_busy(hal_i2c_port_t port) {
+  (void)port;
+  return false;
+}
+
+// ---------------------------------- Flash ------------------------------------
+
+// A área de dados da flash é um arquivo mapeado em memória (SIM_FLASH), que
+// preserva calibração e registros entre execuções, ou memória anônima
+static uint8_t *hal_host_flash_map(void) {
+  if (flash_data) {
+    return flash_data;
+  }
+
+  const char *path = getenv("SIM_FLASH");
+  void *map = MAP_FAILED;
+  if (path) {
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    struct stat st;
+    if (fd >= 0 && fstat(fd, &st) == 0 && ftruncate(fd, HAL_FLASH_DATA_SIZE) == 0) {
+      map = mmap(NULL, HAL_FLASH_DATA_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      // Trecho novo do arquivo começa apagado, como uma flash nova
+      if (map != MAP_FAILED && st.st_size < HAL_FLASH_DATA_SIZE) {
+        memset((uint8_t *)map + st.st_size, 0xFF, HAL_FLASH_DATA_SIZE - st.st_size);
+      }
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+    if (map == MAP_FAILED) {
+      printf("sim: não foi possível mapear SIM_FLASH (%s), usando memória\n", path);
+    }
+  }
+  if (map == MAP_FAILED) {
+    map = mmap(NULL, HAL_FLASH_DATA_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) {
+      printf("sim: falha ao alocar a flash simulada\n");
+      exit(1);
+    }
+    memset(map, 0xFF, HAL_FLASH_DATA_SIZE);
+  }
+
+  flash_data = map;
+  return flash_data;
+}
+
+static bool hal_host_flash_range_valid(uint32_t offset, size_t len, uint32_t alignment) {
+  return !(offset % alignment) && !(len % alignment) &&
+         offset <= HAL_FLASH_DATA_SIZE && len <= HAL_FLASH_DATA_SIZE - offset;
+}
+
+const uint8_t *hal_flash_data(void) {
+  return hal_host_flash_map();
+}
+
+bool hal_flash_erase(uint32_t offset, size_t len) {
+  if (!hal_host_flash_range_valid(offset, len, HAL_FLASH_SECTOR_SIZE)) {
+    return false;
+  }
+  memset(hal_host_flash_map() + offset, 0xFF, len);
+  return true;
+}
+
+bool hal_flash_program(uint32_t offset, const void *src, size_t len) {
+  if (!hal_host_flash_range_valid(offset, len, HAL_FLASH_PAGE_SIZE)) {
+    return false;
+  }
+
+  // Como na NOR flash, a gravação só leva bits de 1 para 0
+  uint8_t *dst = hal_host_flash_map() + offset;
+  const uint8_t *bytes = src;
+  for (size_t i = 0; i < len; i++) {
+    dst[i] &= bytes[i];
+  }
+  return true;
+}
+
+// ----------------------------------- Rede ------------------------------------
+
+int hal_net_init(void) {
+  return 0;
+}
+
+int hal_net_connect(const char *ssid, const char *password, uint32_t timeout_ms) {
+  (void)password;
+  (void)timeout_ms;
+  printf("sim: rede '%s' simulada pelo loopback\n", ssid);
+  return 0;
+}
+
+void hal_net_led_put(bool value) {
+  (void)value;
+}
+
+const char *hal_net_ip_address(void) {
+  return "127.0.0.1";
+}
+
+void hal_net_poll(void) {
+  sim_lwip_poll(0);
+}
+
+// No simulador os callbacks do shim executam na mesma thread do laço principal
+void hal_net_lock(void) {
+}
+
+void hal_net_unlock(void) {
+}
+
+void hal_net_deinit(void) {
+}
@@ -0,0 +1,18 @@
+#ifndef LWIP_SIM_ARCH_H
+#define LWIP_SIM_ARCH_H
+
+// Tipos básicos do lwIP para o shim do simulador (equivalentes a lwip/arch.h)
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t  u8_t;
+typedef int8_t   s8_t;
+typedef uint16_t u16_t;
+typedef int16_t  s16_t;
+typedef uint32_t u32_t;
+typedef int32_t  s32_t;
+
+#define LWIP_UNUSED_ARG(x) (void)(x)
+
+#endif // LWIP_SIM_ARCH_H
@@ -0,0 +1,22 @@
+#ifndef LWIP_SIM_IP_ADDR_H
+#define LWIP_SIM_IP_ADDR_H
+
+#include "lwip/opt.h"
+
+// Endereços IPv4 (armazenados em ordem de rede, como no lwIP)
+typedef struct ip4_addr {
+  u32_t addr;
+} ip4_addr_t;
+
+typedef ip4_addr_t ip_addr_t;
+
+extern const ip_addr_t ip_addr_any;
+#define IP_ADDR_ANY (&ip_addr_any)
+
+#define IP4_ADDR(ipaddr, a, b, c, d) \
+  (ipaddr)->addr = ((u32_t)((d) & 0xff) << 24) | ((u32_t)((c) & 0xff) << 16) | \
+                   ((u32_t)((b) & 0xff) << 8)  |  (u32_t)((a) & 0xff)
+
+char *ipaddr_ntoa(const ip_addr_t *addr);
+
+#endif // LWIP_SIM_IP_ADDR_H
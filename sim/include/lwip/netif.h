@@ -0,0 +1,13 @@
+#ifndef LWIP_SIM_NETIF_H
+#define LWIP_SIM_NETIF_H
+
+#include "lwip/ip_addr.h"
+
+// No simulador existe uma única interface: o loopback (127.0.0.1)
+struct netif {
+  ip_addr_t ip_addr;
+};
+
+extern struct netif *netif_default;
+
+#endif // LWIP_SIM_NETIF_H
@@ -0,0 +1,39 @@
+#ifndef LWIP_SIM_OPT_H
+#define LWIP_SIM_OPT_H
+
+// Opções do lwIP para o shim do simulador. Usa o mesmo lwipopts.h do firmware
+// e completa com os valores padrão do lwIP, de modo que os limites de PCBs,
+// pbufs e buffers de envio sejam os mesmos do Pico W.
+
+#include "lwipopts.h"
+#include "lwip/arch.h"
+
+#ifndef MEMP_NUM_TCP_PCB_LISTEN
+#define MEMP_NUM_TCP_PCB_LISTEN 8
+#endif
+
+#ifndef TCP_MSS
+#define TCP_MSS 536
+#endif
+
+#ifndef TCP_SND_BUF
+#define TCP_SND_BUF (2 * TCP_MSS)
+#endif
+
+#ifndef TCP_WND
+#define TCP_WND (4 * TCP_MSS)
+#endif
+
+#ifndef TCP_SND_QUEUELEN
+#define TCP_SND_QUEUELEN ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
+#endif
+
+#ifndef TCP_SLOW_INTERVAL
+#define TCP_SLOW_INTERVAL 500
+#endif
+
+#ifndef PBUF_POOL_BUFSIZE
+#define PBUF_POOL_BUFSIZE (TCP_MSS + 40 + 14)
+#endif
+
+#endif // LWIP_SIM_OPT_H
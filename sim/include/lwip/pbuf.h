@@ -0,0 +1,35 @@
+#ifndef LWIP_SIM_PBUF_H
+#define LWIP_SIM_PBUF_H
+
+#include "lwip/opt.h"
+#include "lwip/err.h"
+
+// Subconjunto da API de pbufs do lwIP usado pelo firmware
+struct pbuf {
+  struct pbuf *next;
+  void *payload;
+  u16_t tot_len;
+  u16_t len;
+};
+
+// Camada e tipo de pbuf_alloc. O shim só aloca PBUF_RAM contíguo de até
+// SIM_PBUF_CHUNK bytes; a camada (espaço para cabeçalhos) é ignorada.
+typedef enum {
+  PBUF_TRANSPORT = 0,
+  PBUF_IP,
+  PBUF_LINK,
+  PBUF_RAW
+} pbuf_layer;
+
+typedef enum {
+  PBUF_RAM = 0,
+  PBUF_ROM,
+  PBUF_REF,
+  PBUF_POOL
+} pbuf_type;
+
+struct pbuf *pbuf_alloc(pbuf_layer layer, u16_t length, pbuf_type type);
+u8_t pbuf_free(struct pbuf *p);
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset);
+
+#endif // LWIP_SIM_PBUF_H
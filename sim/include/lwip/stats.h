@@ -0,0 +1,58 @@
+#ifndef LWIP_SIM_STATS_H
+#define LWIP_SIM_STATS_H
+
+// Subconjunto de lwip/stats.h mantido pelo shim (sim/lwip_shim.c), com os
+// mesmos nomes do lwIP. Os limites são os de lwipopts.h; o uso é o que o
+// lwIP teria com as mesmas chamadas:
+//  - heap (MEM_SIZE): dados copiados por tcp_write (TCP_WRITE_FLAG_COPY);
+//  - MEMP_PBUF: uma referência por tcp_write sem cópia;
+//  - MEMP_TCP_SEG: segmentos enfileirados, somando todas as conexões;
+//  - MEMP_PBUF_POOL e MEMP_TCP_PCB: os pools do próprio shim;
+//  - heap também para pbuf_alloc(PBUF_RAM) (datagramas UDP).
+// O shim não recusa as chamadas que passariam desses limites, só as conta
+// em err, para que o esgotamento apareça sem mudar o comportamento.
+
+#include "lwip/opt.h"
+
+#if LWIP_STATS
+
+typedef u32_t STAT_COUNTER;
+typedef size_t mem_size_t;
+
+struct stats_proto {
+  STAT_COUNTER xmit;
+  STAT_COUNTER recv;
+  STAT_COUNTER drop;
+  STAT_COUNTER memerr;
+  STAT_COUNTER err;
+};
+
+struct stats_mem {
+  const char *name;
+  STAT_COUNTER err;
+  mem_size_t avail;
+  mem_size_t used;
+  mem_size_t max;
+  STAT_COUNTER illegal;
+};
+
+typedef enum {
+  MEMP_TCP_PCB = 0,
+  MEMP_TCP_SEG,
+  MEMP_PBUF,
+  MEMP_PBUF_POOL,
+  MEMP_MAX
+} memp_t;
+
+struct stats_ {
+  struct stats_proto udp;
+  struct stats_proto tcp;
+  struct stats_mem mem;
+  struct stats_mem *memp[MEMP_MAX];
+};
+
+extern struct stats_ lwip_stats;
+
+#endif // LWIP_STATS
+
+#endif // LWIP_SIM_STATS_H
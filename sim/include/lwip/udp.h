@@ -0,0 +1,16 @@
+#ifndef LWIP_SIM_UDP_H
+#define LWIP_SIM_UDP_H
+
+#include "lwip/opt.h"
+#include "lwip/err.h"
+#include "lwip/ip_addr.h"
+#include "lwip/pbuf.h"
+
+// Subconjunto da API "raw" UDP do lwIP usado pelo firmware (apenas envio)
+struct udp_pcb;
+
+struct udp_pcb *udp_new(void);
+void udp_remove(struct udp_pcb *pcb);
+err_t udp_sendto(struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *dst_ip, u16_t dst_port);
+
+#endif // LWIP_SIM_UDP_H
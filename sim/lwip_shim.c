@@ -0,0 +1,855 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+// <netinet/tcp.h> também define TCP_MSS; vale o valor de lwipopts.h
+#undef TCP_MSS
+
+#include "hal/hal.h"
+#include "sim/sim.h"
+
+#include "lwip/pbuf.h"
+#include "lwip/tcp.h"
+#include "lwip/udp.h"
+#include "lwip/netif.h"
+#include "lwip/stats.h"
+
+/*
+ * Shim da API "raw" TCP do lwIP sobre sockets BSD no loopback.
+ *
+ * Não é um lwIP completo: o controle de fluxo e os timers ficam a cargo do
+ * kernel. O objetivo é executar o código do servidor sem alterações e manter
+ * os mesmos limites do firmware (lwipopts.h), para que esgotamento de PCBs,
+ * pbufs, buffer de envio e janela de recepção apareçam também no simulador:
+ *  - MEMP_NUM_TCP_PCB conexões ativas (as excedentes aguardam no backlog);
+ *  - PBUF_POOL_SIZE pbufs de recepção, entregues em cadeias de até
+ *    SIM_PBUF_CHUNK bytes por pbuf (para exercitar p->tot_len != p->len);
+ *  - TCP_SND_BUF bytes / TCP_SND_QUEUELEN segmentos enfileirados por conexão;
+ *  - janela de recepção TCP_WND, reaberta somente por tcp_recved().
+ * Os bytes aceitos pelo kernel são considerados confirmados e informados pelo
+ * callback sent na próxima chamada de sim_lwip_poll().
+ *
+ * UDP: apenas envio (udp_sendto), por um socket UDP por PCB (até
+ * MEMP_NUM_UDP_PCB). Datagramas multicast saem pela interface de loopback.
+ */
+
+#define SIM_PBUF_CHUNK 256
+#define SIM_LISTEN_BACKLOG 8
+
+typedef enum {
+  SIM_PCB_FREE = 0,
+  SIM_PCB_NEW,
+  SIM_PCB_LISTEN,
+  SIM_PCB_ACTIVE,
+  SIM_PCB_CLOSING
+} sim_pcb_state_t;
+
+struct tcp_pcb {
+  sim_pcb_state_t state;
+  int fd;
+  u16_t local_port;
+
+  void *callback_arg;
+  tcp_accept_fn accept;
+  tcp_recv_fn recv;
+  tcp_sent_fn sent;
+  tcp_poll_fn poll;
+  tcp_err_fn errf;
+  u8_t poll_interval;
+  uint32_t next_poll_ms;
+
+  // Dados enfileirados por tcp_write e ainda não aceitos pelo kernel
+  u8_t snd_data[TCP_SND_BUF];
+  u16_t snd_len;
+  u16_t snd_seg_len[TCP_SND_QUEUELEN];
+  bool snd_seg_copy[TCP_SND_QUEUELEN];  // escrito com TCP_WRITE_FLAG_COPY
+  u16_t snd_queuelen;
+  u32_t acked;  // bytes aceitos pelo kernel e ainda não informados via sent
+  u32_t written;  // total de bytes aceitos por tcp_write
+
+  u16_t rcv_wnd;
+  bool fin_received;
+  bool reset;  // envio falhou dentro de tcp_output; o erro é tratado no próximo poll
+  struct pbuf *refused_data;
+};
+
+typedef struct {
+  struct pbuf p;
+  bool used;
+  bool ram;  // alocado por pbuf_alloc(PBUF_RAM): no lwIP viria do heap
+  u8_t payload[SIM_PBUF_CHUNK];
+} sim_pbuf_t;
+
+struct udp_pcb {
+  bool used;
+  int fd;
+};
+
+static struct tcp_pcb tcp_pcb_pool[MEMP_NUM_TCP_PCB];
+static struct tcp_pcb tcp_listen_pool[MEMP_NUM_TCP_PCB_LISTEN];
+static sim_pbuf_t pbuf_pool[PBUF_POOL_SIZE];
+static struct udp_pcb udp_pcb_pool[MEMP_NUM_UDP_PCB];
+
+const ip_addr_t ip_addr_any = { 0 };
+static struct netif loopback_netif = { .ip_addr = { 0x0100007Fu } };
+struct netif *netif_default = &loopback_netif;
+
+// -------------------------------- Estatísticas -------------------------------
+
+#if LWIP_STATS
+static struct stats_mem memp_stats[MEMP_MAX] = {
+  [MEMP_TCP_PCB]   = { .name = "TCP_PCB", .avail = MEMP_NUM_TCP_PCB },
+  [MEMP_TCP_SEG]   = { .name = "TCP_SEG", .avail = MEMP_NUM_TCP_SEG },
+  [MEMP_PBUF]      = { .name = "PBUF", .avail = MEMP_NUM_PBUF },
+  [MEMP_PBUF_POOL] = { .name = "PBUF_POOL", .avail = PBUF_POOL_SIZE },
+};
+
+struct stats_ lwip_stats = {
+  .mem = { .name = "HEAP", .avail = MEM_SIZE },
+  .memp = { &memp_stats[MEMP_TCP_PCB], &memp_stats[MEMP_TCP_SEG], &memp_stats[MEMP_PBUF], &memp_stats[MEMP_PBUF_POOL] },
+};
+
+static void sim_stats_use(struct stats_mem *stats, mem_size_t amount) {
+  stats->used += amount;
+  if (stats->used > stats->max) {
+    stats->max = stats->used;
+  }
+  if (stats->used > stats->avail) {
+    stats->err++;
+  }
+}
+
+static void sim_stats_release(struct stats_mem *stats, mem_size_t amount) {
+  stats->used -= amount;
+}
+
+#define SIM_STATS_INC(field) (lwip_stats.field++)
+#else
+#define sim_stats_use(stats, amount) ((void)0)
+#define sim_stats_release(stats, amount) ((void)0)
+#define SIM_STATS_INC(field) ((void)0)
+#endif
+
+// Recursos que o lwIP ocuparia com o segmento de envio i do PCB
+static void sim_segment_use(struct tcp_pcb *pcb, u16_t i) {
+  sim_stats_use(lwip_stats.memp[MEMP_TCP_SEG], 1);
+  if (pcb->snd_seg_copy[i]) {
+    sim_stats_use(&lwip_stats.mem, pcb->snd_seg_len[i]);
+  } else {
+    sim_stats_use(lwip_stats.memp[MEMP_PBUF], 1);
+  }
+}
+
+static void sim_segment_release(struct tcp_pcb *pcb, u16_t i, u16_t len) {
+  sim_stats_release(lwip_stats.memp[MEMP_TCP_SEG], 1);
+  if (pcb->snd_seg_copy[i]) {
+    sim_stats_release(&lwip_stats.mem, len);
+  } else {
+    sim_stats_release(lwip_stats.memp[MEMP_PBUF], 1);
+  }
+}
+
+// ---------------------------------- pbufs ------------------------------------
+
+static u16_t sim_pbuf_free_count(void) {
+  u16_t count = 0;
+  for (int i = 0; i < PBUF_POOL_SIZE; i++) {
+    if (!pbuf_pool[i].used) {
+      count++;
+    }
+  }
+  return count;
+}
+
+static struct pbuf *sim_pbuf_alloc(const u8_t *data, u16_t len) {
+  struct pbuf *head = NULL;
+  struct pbuf *tail = NULL;
+  u16_t offset = 0;
+
+  for (int i = 0; i < PBUF_POOL_SIZE && offset < len; i++) {
+    if (pbuf_pool[i].used) {
+      continue;
+    }
+
+    sim_pbuf_t *slot = &pbuf_pool[i];
+    u16_t chunk = len - offset;
+    if (chunk > SIM_PBUF_CHUNK) {
+      chunk = SIM_PBUF_CHUNK;
+    }
+
+    slot->used = true;
+    slot->ram = false;
+    sim_stats_use(lwip_stats.memp[MEMP_PBUF_POOL], 1);
+    memcpy(slot->payload, data + offset, chunk);
+    slot->p.next = NULL;
+    slot->p.payload = slot->payload;
+    slot->p.len = chunk;
+    slot->p.tot_len = len - offset;
+
+    if (tail) {
+      tail->next = &slot->p;
+    } else {
+      head = &slot->p;
+    }
+    tail = &slot->p;
+    offset += chunk;
+  }
+
+  return head;
+}
+
+struct pbuf *pbuf_alloc(pbuf_layer layer, u16_t length, pbuf_type type) {
+  (void)layer;
+  if (type != PBUF_RAM || length > SIM_PBUF_CHUNK) {
+    return NULL;
+  }
+
+  for (int i = 0; i < PBUF_POOL_SIZE; i++) {
+    sim_pbuf_t *slot = &pbuf_pool[i];
+    if (slot->used) {
+      continue;
+    }
+
+    slot->used = true;
+    slot->ram = true;
+    sim_stats_use(&lwip_stats.mem, length);
+    slot->p.next = NULL;
+    slot->p.payload = slot->payload;
+    slot->p.len = length;
+    slot->p.tot_len = length;
+    return &slot->p;
+  }
+  return NULL;
+}
+
+u8_t pbuf_free(struct pbuf *p) {
+  u8_t count = 0;
+  while (p) {
+    struct pbuf *next = p->next;
+    sim_pbuf_t *slot = (sim_pbuf_t *)p;
+    slot->used = false;
+    if (slot->ram) {
+      sim_stats_release(&lwip_stats.mem, p->len);
+    } else {
+      sim_stats_release(lwip_stats.memp[MEMP_PBUF_POOL], 1);
+    }
+    p = next;
+    count++;
+  }
+  return count;
+}
+
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset) {
+  u16_t copied = 0;
+  for (; p && copied < len; p = p->next) {
+    if (offset >= p->len) {
+      offset -= p->len;
+      continue;
+    }
+    u16_t chunk = p->len - offset;
+    if (chunk > len - copied) {
+      chunk = len - copied;
+    }
+    memcpy((u8_t *)dataptr + copied, (const u8_t *)p->payload + offset, chunk);
+    copied += chunk;
+    offset = 0;
+  }
+  return copied;
+}
+
+// --------------------------------- Endereços ---------------------------------
+
+char *ipaddr_ntoa(const ip_addr_t *addr) {
+  static char text[16];
+  u32_t ip = addr->addr;
+  snprintf(text, sizeof(text), "%u.%u.%u.%u",
+           (unsigned)(ip & 0xff), (unsigned)((ip >> 8) & 0xff),
+           (unsigned)((ip >> 16) & 0xff), (unsigned)((ip >> 24) & 0xff));
+  return text;
+}
+
+// ----------------------------------- PCBs ------------------------------------
+
+static struct tcp_pcb *sim_pcb_alloc(struct tcp_pcb *pool, int count) {
+  for (int i = 0; i < count; i++) {
+    if (pool[i].state == SIM_PCB_FREE) {
+      memset(&pool[i], 0, sizeof(pool[i]));
+      pool[i].fd = -1;
+      pool[i].rcv_wnd = TCP_WND;
+      if (pool == tcp_pcb_pool) {
+        sim_stats_use(lwip_stats.memp[MEMP_TCP_PCB], 1);
+      }
+      return &pool[i];
+    }
+  }
+#if LWIP_STATS
+  if (pool == tcp_pcb_pool) {
+    lwip_stats.memp[MEMP_TCP_PCB]->err++;
+  }
+#endif
+  return NULL;
+}
+
+static void sim_pcb_free(struct tcp_pcb *pcb) {
+  if (pcb->fd >= 0) {
+    close(pcb->fd);
+  }
+  if (pcb->refused_data) {
+    pbuf_free(pcb->refused_data);
+  }
+  for (u16_t i = 0; i < pcb->snd_queuelen; i++) {
+    sim_segment_release(pcb, i, pcb->snd_seg_len[i]);
+  }
+  if (pcb >= tcp_pcb_pool && pcb < tcp_pcb_pool + MEMP_NUM_TCP_PCB && pcb->state != SIM_PCB_FREE) {
+    sim_stats_release(lwip_stats.memp[MEMP_TCP_PCB], 1);
+  }
+  pcb->snd_len = 0;
+  pcb->snd_queuelen = 0;
+  pcb->fd = -1;
+  pcb->refused_data = NULL;
+  pcb->state = SIM_PCB_FREE;
+}
+
+// Conexão perdida: como no lwIP, o PCB é liberado antes do callback de erro
+static void sim_pcb_report_error(struct tcp_pcb *pcb, err_t err) {
+  tcp_err_fn errf = pcb->errf;
+  void *arg = pcb->callback_arg;
+  sim_pcb_free(pcb);
+  if (errf) {
+    errf(arg, err);
+  }
+}
+
+static bool sim_pcb_has_free_slot(void) {
+  for (int i = 0; i < MEMP_NUM_TCP_PCB; i++) {
+    if (tcp_pcb_pool[i].state == SIM_PCB_FREE) {
+      return true;
+    }
+  }
+  return false;
+}
+
+struct tcp_pcb *tcp_new(void) {
+  struct tcp_pcb *pcb = sim_pcb_alloc(tcp_pcb_pool, MEMP_NUM_TCP_PCB);
+  if (pcb) {
+    pcb->state = SIM_PCB_NEW;
+  }
+  return pcb;
+}
+
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port) {
+  (void)ipaddr;
+
+  int offset = 8000;
+  const char *value = getenv("SIM_PORT_OFFSET");
+  if (value) {
+    offset = atoi(value);
+  }
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return ERR_MEM;
+  }
+
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  struct sockaddr_in addr = { 0 };
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons((uint16_t)(port + offset));
+
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    close(fd);
+    return ERR_USE;
+  }
+
+  printf("sim: porta %u mapeada para 127.0.0.1:%u\n", port, (unsigned)(port + offset));
+  pcb->fd = fd;
+  pcb->local_port = port;
+  return ERR_OK;
+}
+
+struct tcp_pcb *tcp_listen(struct tcp_pcb *pcb) {
+  // Assim como no lwIP, o PCB original é liberado e um PCB de escuta é retornado
+  struct tcp_pcb *lpcb = sim_pcb_alloc(tcp_listen_pool, MEMP_NUM_TCP_PCB_LISTEN);
+  if (!lpcb || listen(pcb->fd, SIM_LISTEN_BACKLOG) < 0) {
+    return NULL;
+  }
+
+  fcntl(pcb->fd, F_SETFL, fcntl(pcb->fd, F_GETFL) | O_NONBLOCK);
+  lpcb->state = SIM_PCB_LISTEN;
+  lpcb->fd = pcb->fd;
+  lpcb->local_port = pcb->local_port;
+  lpcb->callback_arg = pcb->callback_arg;
+
+  pcb->fd = -1;
+  sim_pcb_free(pcb);
+  return lpcb;
+}
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg) {
+  pcb->callback_arg = arg;
+}
+
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept) {
+  pcb->accept = accept;
+}
+
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv) {
+  pcb->recv = recv;
+}
+
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent) {
+  pcb->sent = sent;
+}
+
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval) {
+  pcb->poll = poll;
+  pcb->poll_interval = interval;
+  pcb->next_poll_ms = hal_time_ms() + interval * TCP_SLOW_INTERVAL;
+}
+
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err) {
+  pcb->errf = err;
+}
+
+void tcp_recved(struct tcp_pcb *pcb, u16_t len) {
+  u32_t wnd = (u32_t)pcb->rcv_wnd + len;
+  pcb->rcv_wnd = wnd > TCP_WND ? TCP_WND : (u16_t)wnd;
+}
+
+u16_t tcp_sndbuf(const struct tcp_pcb *pcb) {
+  return TCP_SND_BUF - pcb->snd_len;
+}
+
+u16_t tcp_sndqueuelen(const struct tcp_pcb *pcb) {
+  return pcb->snd_queuelen;
+}
+
+err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, u16_t len, u8_t apiflags) {
+  if (pcb->state != SIM_PCB_ACTIVE) {
+    return ERR_CONN;
+  }
+  if (len > tcp_sndbuf(pcb) || pcb->snd_queuelen >= TCP_SND_QUEUELEN) {
+    SIM_STATS_INC(tcp.memerr);
+    return ERR_MEM;
+  }
+
+  memcpy(pcb->snd_data + pcb->snd_len, dataptr, len);
+  pcb->snd_len += len;
+  pcb->snd_seg_len[pcb->snd_queuelen] = len;
+  pcb->snd_seg_copy[pcb->snd_queuelen] = (apiflags & TCP_WRITE_FLAG_COPY) != 0;
+  pcb->written += len;
+  sim_segment_use(pcb, pcb->snd_queuelen);
+  pcb->snd_queuelen++;
+  return ERR_OK;
+}
+
+// Envia o que couber no socket; retorna false se a conexão foi perdida. Com
+// defer_error (chamada pela aplicação, via tcp_output), uma conexão perdida só
+// é marcada: como no lwIP, o PCB não pode ser liberado nem o callback de erro
+// chamado de dentro de tcp_output.
+static bool sim_pcb_flush(struct tcp_pcb *pcb, bool defer_error) {
+  if (!pcb->snd_len || pcb->reset) {
+    return !pcb->reset;
+  }
+
+  // PCB sem socket (sim_lwip_detached_pcb): tudo é entregue de uma vez
+  ssize_t n = pcb->fd < 0 ? (ssize_t)pcb->snd_len : send(pcb->fd, pcb->snd_data, pcb->snd_len, MSG_NOSIGNAL | MSG_DONTWAIT);
+  if (n < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+      return true;
+    }
+    if (defer_error) {
+      pcb->reset = true;
+    } else if (pcb->state == SIM_PCB_CLOSING) {
+      sim_pcb_free(pcb);
+    } else {
+      sim_pcb_report_error(pcb, ERR_RST);
+    }
+    return false;
+  }
+
+  memmove(pcb->snd_data, pcb->snd_data + n, pcb->snd_len - n);
+  pcb->snd_len -= (u16_t)n;
+  SIM_STATS_INC(tcp.xmit);
+
+  // Remove os segmentos completamente enviados
+  u16_t acked = (u16_t)n;
+  while (acked && pcb->snd_queuelen) {
+    if (pcb->snd_seg_len[0] > acked) {
+      // Segmento copiado parcialmente aceito: libera a parte já enviada
+      if (pcb->snd_seg_copy[0]) {
+        sim_stats_release(&lwip_stats.mem, acked);
+      }
+      pcb->snd_seg_len[0] -= acked;
+      break;
+    }
+    acked -= pcb->snd_seg_len[0];
+    sim_segment_release(pcb, 0, pcb->snd_seg_len[0]);
+    memmove(pcb->snd_seg_len, pcb->snd_seg_len + 1, (pcb->snd_queuelen - 1) * sizeof(u16_t));
+    memmove(pcb->snd_seg_copy, pcb->snd_seg_copy + 1, (pcb->snd_queuelen - 1) * sizeof(bool));
+    pcb->snd_queuelen--;
+  }
+
+  pcb->acked += (u32_t)n;
+  return true;
+}
+
+err_t tcp_output(struct tcp_pcb *pcb) {
+  if (pcb->state == SIM_PCB_ACTIVE) {
+    sim_pcb_flush(pcb, true);
+  }
+  return ERR_OK;
+}
+
+err_t tcp_close(struct tcp_pcb *pcb) {
+  if (pcb->state != SIM_PCB_ACTIVE) {
+    sim_pcb_free(pcb);
+    return ERR_OK;
+  }
+
+  // A partir daqui a aplicação não recebe mais callbacks deste PCB
+  pcb->state = SIM_PCB_CLOSING;
+  pcb->recv = NULL;
+  pcb->sent = NULL;
+  pcb->poll = NULL;
+  pcb->errf = NULL;
+  if (pcb->refused_data) {
+    pbuf_free(pcb->refused_data);
+    pcb->refused_data = NULL;
+  }
+  return ERR_OK;
+}
+
+void tcp_abort(struct tcp_pcb *pcb) {
+  if (pcb->fd >= 0 && pcb->state != SIM_PCB_LISTEN) {
+    // Fecha com RST
+    struct linger lin = { .l_onoff = 1, .l_linger = 0 };
+    setsockopt(pcb->fd, SOL_SOCKET, SO_LINGER, &lin, sizeof(lin));
+  }
+  sim_pcb_report_error(pcb, ERR_ABRT);
+}
+
+// ------------------------------------ UDP ------------------------------------
+
+struct udp_pcb *udp_new(void) {
+  for (int i = 0; i < MEMP_NUM_UDP_PCB; i++) {
+    struct udp_pcb *pcb = &udp_pcb_pool[i];
+    if (pcb->used) {
+      continue;
+    }
+
+    pcb->fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (pcb->fd < 0) {
+      return NULL;
+    }
+
+    // Multicast pela interface de loopback, entregue também aos receptores locais
+    struct in_addr loopback = { .s_addr = htonl(INADDR_LOOPBACK) };
+    int one = 1;
+    setsockopt(pcb->fd, IPPROTO_IP, IP_MULTICAST_IF, &loopback, sizeof(loopback));
+    setsockopt(pcb->fd, IPPROTO_IP, IP_MULTICAST_LOOP, &one, sizeof(one));
+    setsockopt(pcb->fd, SOL_SOCKET, SO_BROADCAST, &one, sizeof(one));
+    fcntl(pcb->fd, F_SETFL, fcntl(pcb->fd, F_GETFL) | O_NONBLOCK);
+
+    pcb->used = true;
+    return pcb;
+  }
+  return NULL;
+}
+
+void udp_remove(struct udp_pcb *pcb) {
+  close(pcb->fd);
+  pcb->used = false;
+}
+
+err_t udp_sendto(struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *dst_ip, u16_t dst_port) {
+  u8_t datagram[SIM_PBUF_CHUNK];
+  if (p->tot_len > sizeof(datagram)) {
+    return ERR_VAL;
+  }
+  u16_t len = pbuf_copy_partial(p, datagram, p->tot_len, 0);
+
+  struct sockaddr_in addr = { 0 };
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = dst_ip->addr;
+  addr.sin_port = htons(dst_port);
+
+  if (sendto(pcb->fd, datagram, len, 0, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    SIM_STATS_INC(udp.err);
+    return ERR_RTE;
+  }
+  SIM_STATS_INC(udp.xmit);
+  return ERR_OK;
+}
+
+// --------------------------------- Eventos -----------------------------------
+
+// Entrega dados (ou FIN, quando p == NULL) ao callback de recepção
+static bool sim_pcb_deliver(struct tcp_pcb *pcb, struct pbuf *p) {
+  err_t err;
+
+  if (pcb->recv) {
+    err = pcb->recv(pcb->callback_arg, pcb, p, ERR_OK);
+  } else {
+    // Comportamento de tcp_recv_null do lwIP
+    if (p) {
+      tcp_recved(pcb, p->tot_len);
+      pbuf_free(p);
+    } else {
+      tcp_close(pcb);
+    }
+    err = ERR_OK;
+  }
+
+  if (err == ERR_ABRT || pcb->state != SIM_PCB_ACTIVE) {
+    return false;
+  }
+  if (err != ERR_OK && p) {
+    // Dados recusados são entregues novamente mais tarde
+    pcb->refused_data = p;
+  }
+  return true;
+}
+
+static void sim_pcb_accept(struct tcp_pcb *lpcb) {
+  while (sim_pcb_has_free_slot()) {
+    int fd = accept(lpcb->fd, NULL, NULL);
+    if (fd < 0) {
+      return;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    struct tcp_pcb *pcb = sim_pcb_alloc(tcp_pcb_pool, MEMP_NUM_TCP_PCB);
+    pcb->state = SIM_PCB_ACTIVE;
+    pcb->fd = fd;
+    pcb->local_port = lpcb->local_port;
+    pcb->callback_arg = lpcb->callback_arg;
+
+    if (!lpcb->accept || lpcb->accept(pcb->callback_arg, pcb, ERR_OK) != ERR_OK) {
+      if (pcb->state != SIM_PCB_FREE) {
+        tcp_abort(pcb);
+      }
+    }
+  }
+}
+
+static void sim_pcb_receive(struct tcp_pcb *pcb) {
+  u16_t room = sim_pbuf_free_count() * SIM_PBUF_CHUNK;
+  if (room > TCP_MSS) {
+    room = TCP_MSS;
+  }
+  if (room > pcb->rcv_wnd) {
+    room = pcb->rcv_wnd;
+  }
+  if (!room) {
+    return;
+  }
+
+  u8_t segment[TCP_MSS];
+  ssize_t n = recv(pcb->fd, segment, room, MSG_DONTWAIT);
+  if (n < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      sim_pcb_report_error(pcb, ERR_RST);
+    }
+    return;
+  }
+
+  if (n == 0) {
+    pcb->fin_received = true;
+    sim_pcb_deliver(pcb, NULL);
+    return;
+  }
+
+  pcb->rcv_wnd -= (u16_t)n;
+  SIM_STATS_INC(tcp.recv);
+  sim_pcb_deliver(pcb, sim_pbuf_alloc(segment, (u16_t)n));
+}
+
+struct tcp_pcb *sim_lwip_detached_pcb(void) {
+  struct tcp_pcb *pcb = sim_pcb_alloc(tcp_pcb_pool, MEMP_NUM_TCP_PCB);
+  if (pcb) {
+    pcb->state = SIM_PCB_ACTIVE;
+  }
+  return pcb;
+}
+
+uint32_t sim_lwip_inject(struct tcp_pcb *pcb, const void *data, uint16_t len) {
+  if (pcb->state != SIM_PCB_ACTIVE || len > pcb->rcv_wnd) {
+    return 0;
+  }
+
+  struct pbuf *p = sim_pbuf_alloc(data, len);
+  if (!p) {
+    return 0;
+  }
+
+  u32_t written = pcb->written;
+  pcb->rcv_wnd -= len;
+  SIM_STATS_INC(tcp.recv);
+  sim_pcb_deliver(pcb, p);
+  return pcb->written - written;
+}
+
+// Pipe que interrompe o poll() quando outra thread sinaliza um evento
+static int sim_wake_pipe[2] = {-1, -1};
+static pthread_once_t sim_wake_once = PTHREAD_ONCE_INIT;
+
+static void sim_wake_init(void) {
+  if (pipe(sim_wake_pipe) != 0) {
+    sim_wake_pipe[0] = sim_wake_pipe[1] = -1;
+    return;
+  }
+  for (int i = 0; i < 2; i++) {
+    fcntl(sim_wake_pipe[i], F_SETFL, O_NONBLOCK);
+    fcntl(sim_wake_pipe[i], F_SETFD, FD_CLOEXEC);
+  }
+}
+
+void sim_lwip_wake(void) {
+  pthread_once(&sim_wake_once, sim_wake_init);
+  if (sim_wake_pipe[1] >= 0) {
+    char byte = 0;
+    (void)!write(sim_wake_pipe[1], &byte, 1); // pipe cheio: já há um despertar pendente
+  }
+}
+
+void sim_lwip_poll(int timeout_ms) {
+  struct pollfd fds[MEMP_NUM_TCP_PCB_LISTEN + MEMP_NUM_TCP_PCB + 1];
+  struct tcp_pcb *owners[MEMP_NUM_TCP_PCB_LISTEN + MEMP_NUM_TCP_PCB + 1];
+  nfds_t nfds = 0;
+  uint32_t now = hal_time_ms();
+
+  pthread_once(&sim_wake_once, sim_wake_init);
+  if (sim_wake_pipe[0] >= 0) {
+    fds[nfds] = (struct pollfd){ .fd = sim_wake_pipe[0], .events = POLLIN };
+    owners[nfds++] = NULL;
+  }
+
+  bool free_slot = sim_pcb_has_free_slot();
+  for (int i = 0; i < MEMP_NUM_TCP_PCB_LISTEN; i++) {
+    struct tcp_pcb *lpcb = &tcp_listen_pool[i];
+    if (lpcb->state == SIM_PCB_LISTEN && free_slot) {
+      fds[nfds] = (struct pollfd){ .fd = lpcb->fd, .events = POLLIN };
+      owners[nfds++] = lpcb;
+    }
+  }
+
+  for (int i = 0; i < MEMP_NUM_TCP_PCB; i++) {
+    struct tcp_pcb *pcb = &tcp_pcb_pool[i];
+
+    if (pcb->state == SIM_PCB_CLOSING && (!pcb->snd_len || pcb->reset)) {
+      sim_pcb_free(pcb);
+      continue;
+    }
+    if (pcb->state != SIM_PCB_ACTIVE && pcb->state != SIM_PCB_CLOSING) {
+      continue;
+    }
+    if (pcb->reset) {
+      sim_pcb_report_error(pcb, ERR_RST);
+      continue;
+    }
+
+    short events = 0;
+    if (pcb->state == SIM_PCB_ACTIVE && !pcb->fin_received && !pcb->refused_data && pcb->rcv_wnd) {
+      events |= POLLIN;
+    }
+    if (pcb->snd_len) {
+      events |= POLLOUT;
+    }
+    if (pcb->state == SIM_PCB_ACTIVE && pcb->poll) {
+      int32_t until_poll = (int32_t)(pcb->next_poll_ms - now);
+      if (until_poll < 0) {
+        until_poll = 0;
+      }
+      if (timeout_ms < 0 || until_poll < timeout_ms) {
+        timeout_ms = until_poll;
+      }
+    }
+
+    fds[nfds] = (struct pollfd){ .fd = pcb->fd, .events = events };
+    owners[nfds++] = pcb;
+  }
+
+  if (poll(fds, nfds, timeout_ms) < 0) {
+    return;
+  }
+
+  for (nfds_t i = 0; i < nfds; i++) {
+    struct tcp_pcb *pcb = owners[i];
+    short revents = fds[i].revents;
+
+    if (!pcb) {
+      char drain[64];
+      while (read(fds[i].fd, drain, sizeof(drain)) > 0) {
+      }
+      continue;
+    }
+
+    if (pcb->state == SIM_PCB_LISTEN) {
+      if (revents & POLLIN) {
+        sim_pcb_accept(pcb);
+      }
+      continue;
+    }
+
+    if (pcb->fd != fds[i].fd) {
+      continue; // PCB liberado por um callback anterior
+    }
+
+    if ((revents & POLLOUT) && !sim_pcb_flush(pcb, false)) {
+      continue;
+    }
+    if (pcb->state == SIM_PCB_ACTIVE && (revents & (POLLIN | POLLHUP | POLLERR))) {
+      sim_pcb_receive(pcb);
+    }
+  }
+
+  // Dados recusados e callbacks periódicos (tcp_poll)
+  now = hal_time_ms();
+  for (int i = 0; i < MEMP_NUM_TCP_PCB; i++) {
+    struct tcp_pcb *pcb = &tcp_pcb_pool[i];
+    if (pcb->state != SIM_PCB_ACTIVE) {
+      continue;
+    }
+
+    if (pcb->refused_data) {
+      struct pbuf *p = pcb->refused_data;
+      pcb->refused_data = NULL;
+      if (!sim_pcb_deliver(pcb, p)) {
+        continue;
+      }
+    }
+
+    // Como no lwIP, o callback sent nunca é chamado de dentro de tcp_output
+    if (pcb->acked) {
+      u16_t acked = pcb->acked > 0xFFFF ? 0xFFFF : (u16_t)pcb->acked;
+      pcb->acked -= acked;
+      if (pcb->sent && pcb->sent(pcb->callback_arg, pcb, acked) == ERR_ABRT) {
+        continue;
+      }
+      if (pcb->state != SIM_PCB_ACTIVE) {
+        continue;
+      }
+    }
+
+    if (pcb->poll && (int32_t)(now - pcb->next_poll_ms) >= 0) {
+      pcb->next_poll_ms = now + pcb->poll_interval * TCP_SLOW_INTERVAL;
+      pcb->poll(pcb->callback_arg, pcb);
+    }
+  }
+}
@@ -0,0 +1,100 @@
+#ifndef SIM_H
+#define SIM_H
+
+/*
+ * API exclusiva do simulador para Linux. Permite que ferramentas de host
+ * (benchmarks, geradores de carga) controlem o hardware simulado e leiam
+ * as estatísticas coletadas.
+ *
+ * Variáveis de ambiente reconhecidas:
+ *  SIM_RX          resistência desconhecida simulada em ohms (padrão 1000)
+ *  SIM_RREF        resistores de referência das faixas, em ohms, separados por
+ *                  vírgula, ligados aos GPIOs 16, 17, 18 e 19 (padrão
+ *                  "330,3300,33000,330000")
+ *  SIM_ADC_NOISE   desvio padrão do ruído do ADC em LSB (padrão 2)
+ *  SIM_ADC_OFFSET  erro de offset do ADC em LSB (padrão 0)
+ *  SIM_ADC_GAIN    erro de ganho do ADC (padrão 1)
+ *  SIM_ADC_DNL     largura extra, em LSB, dos códigos 512, 1536, 2560 e 3584
+ *                  (picos de DNL do ADC do RP2040; padrão 0)
+ *  SIM_FLASH       arquivo que guarda a área de dados da flash entre execuções
+ *  SIM_PORT_OFFSET deslocamento somado às portas TCP (padrão 8000, 80 => 8080)
+ *  SIM_OLED_PBM    caminho de um arquivo .pbm atualizado a cada quadro do OLED
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// ------------------------------- ADC simulado --------------------------------
+
+// Resistência desconhecida ligada entre o nó do divisor e o GND
+void sim_adc_set_unknown(float ohms);
+float sim_adc_get_unknown(void);
+
+// Resistor de referência ligado entre o GPIO de uma faixa e o nó do divisor.
+// Só conduz com o pino configurado como saída: em nível alto puxa o nó para
+// 3.3V e em nível baixo para o GND. ohms <= 0 remove a referência do pino.
+void sim_adc_set_reference(unsigned gpio, float ohms);
+
+// Desvio padrão do ruído gaussiano somado a cada conversão (em LSB)
+void sim_adc_set_noise(float lsb);
+
+// Erros do ADC: leitura = ganho * ideal + offset, com os picos de DNL
+void sim_adc_set_errors(float offset_lsb, float gain, float dnl_lsb);
+
+// Gera uma conversão de 12 bits para o canal informado
+uint16_t sim_adc_sample(unsigned input);
+
+// ------------------------------- OLED simulado -------------------------------
+
+typedef struct {
+  uint32_t transactions;    // transações I2C recebidas
+  uint32_t bytes;           // bytes transferidos (incluindo o byte de controle)
+  uint32_t frames;          // transferências de dados para a GDDRAM
+  uint64_t bus_time_us;     // tempo estimado de barramento (9 bits por byte)
+} sim_oled_stats_t;
+
+// Recebe uma escrita I2C destinada ao SSD1306 e atualiza a GDDRAM simulada
+void sim_oled_i2c_write(uint8_t address, const uint8_t *src, size_t len, uint32_t baudrate);
+
+// Valor de um pixel da GDDRAM simulada
+bool sim_oled_pixel(uint8_t x, uint8_t y);
+
+void sim_oled_get_stats(sim_oled_stats_t *stats);
+void sim_oled_reset_stats(void);
+
+// Desenha o conteúdo atual do display em texto
+void sim_oled_dump(FILE *out);
+
+// Grava o conteúdo atual do display em uma imagem PBM
+bool sim_oled_write_pbm(const char *path);
+
+// --------------------------------- GPIO --------------------------------------
+
+// Nível de um pino configurado como saída (0 ou 1), ou -1 se for entrada
+int sim_gpio_output_level(unsigned gpio);
+
+// Simula uma borda no pino, disparando o callback de interrupção registrado
+void sim_gpio_trigger(unsigned gpio, bool level);
+
+// ------------------------------ Rede (lwIP shim) -----------------------------
+
+// Atende os sockets do shim por até timeout_ms milissegundos e dispara os
+// callbacks do lwIP (accept, recv, sent, poll, err)
+void sim_lwip_poll(int timeout_ms);
+
+// Faz um sim_lwip_poll() em espera (ou o próximo) retornar de imediato. Pode
+// ser chamada de qualquer thread (hal_event_signal).
+void sim_lwip_wake(void);
+
+// Conexão ativa sem socket, para medir o servidor sem passar pelo kernel. O
+// que a aplicação escreve é dado como entregue no tcp_output e confirmado
+// (callback sent) no próximo sim_lwip_poll(). Retorna NULL sem PCB livre.
+struct tcp_pcb *sim_lwip_detached_pcb(void);
+
+// Entrega len bytes ao callback de recepção do PCB, como se tivessem chegado
+// pela rede. Retorna quantos bytes a aplicação escreveu (tcp_write) durante
+// o callback.
+uint32_t sim_lwip_inject(struct tcp_pcb *pcb, const void *data, uint16_t len);
+
+#endif // SIM_H
@@ -0,0 +1,147 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include "sim/sim.h"
+
+// Modelo do divisor de tensão: GPIO (3.3V) -- Rref -- nó (ADC) -- Rx -- GND,
+// com um resistor de referência por faixa (GPIOs 16 a 19)
+#define SIM_ADC_RANGE_COUNT 4
+
+static const unsigned range_gpio[SIM_ADC_RANGE_COUNT] = {16, 17, 18, 19};
+static float range_reference_ohms[SIM_ADC_RANGE_COUNT] = {330.0f, 3300.0f, 33000.0f, 330000.0f};
+static float unknown_ohms = 1000.0f;
+static float noise_lsb = 2.0f;
+static float offset_lsb = 0.0f;
+static float gain = 1.0f;
+static float dnl_lsb = 0.0f;
+static bool env_loaded = false;
+
+// Gerador pseudoaleatório determinístico (xorshift32) para o ruído
+static uint32_t noise_state = 0x12345678u;
+
+static void sim_adc_load_env(void) {
+  if (env_loaded) {
+    return;
+  }
+  env_loaded = true;
+
+  const char *value = getenv("SIM_RX");
+  if (value) {
+    unknown_ohms = strtof(value, NULL);
+  }
+  value = getenv("SIM_RREF");
+  for (int i = 0; value && *value && i < SIM_ADC_RANGE_COUNT; i++) {
+    char *end;
+    range_reference_ohms[i] = strtof(value, &end);
+    value = (*end == ',') ? end + 1 : NULL;
+  }
+  value = getenv("SIM_ADC_NOISE");
+  if (value) {
+    noise_lsb = strtof(value, NULL);
+  }
+  value = getenv("SIM_ADC_OFFSET");
+  if (value) {
+    offset_lsb = strtof(value, NULL);
+  }
+  value = getenv("SIM_ADC_GAIN");
+  if (value) {
+    gain = strtof(value, NULL);
+  }
+  value = getenv("SIM_ADC_DNL");
+  if (value) {
+    dnl_lsb = strtof(value, NULL);
+  }
+}
+
+static float sim_adc_uniform(void) {
+  noise_state ^= noise_state << 13;
+  noise_state ^= noise_state >> 17;
+  noise_state ^= noise_state << 5;
+  return (noise_state >> 8) * (1.0f / 16777216.0f);
+}
+
+static float sim_adc_gaussian(void) {
+  // Box-Muller
+  float u1 = sim_adc_uniform();
+  float u2 = sim_adc_uniform();
+  if (u1 < 1e-7f) {
+    u1 = 1e-7f;
+  }
+  return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+void sim_adc_set_unknown(float ohms) {
+  sim_adc_load_env();
+  unknown_ohms = ohms;
+}
+
+float sim_adc_get_unknown(void) {
+  sim_adc_load_env();
+  return unknown_ohms;
+}
+
+void sim_adc_set_reference(unsigned gpio, float ohms) {
+  sim_adc_load_env();
+  for (int i = 0; i < SIM_ADC_RANGE_COUNT; i++) {
+    if (range_gpio[i] == gpio) {
+      range_reference_ohms[i] = ohms;
+    }
+  }
+}
+
+void sim_adc_set_noise(float lsb) {
+  sim_adc_load_env();
+  noise_lsb = lsb;
+}
+
+void sim_adc_set_errors(float offset, float gain_error, float dnl) {
+  sim_adc_load_env();
+  offset_lsb = offset;
+  gain = gain_error;
+  dnl_lsb = dnl;
+}
+
+uint16_t sim_adc_sample(unsigned input) {
+  (void)input;
+  sim_adc_load_env();
+
+  // Tensão no nó pelas condutâncias ligadas ao 3.3V (referências em nível
+  // alto) e ao GND (referências em nível baixo e Rx)
+  float to_vdd = 0.0f;
+  float to_gnd = unknown_ohms > 0.0f ? 1.0f / unknown_ohms : 1e30f;
+  for (int i = 0; i < SIM_ADC_RANGE_COUNT; i++) {
+    int level = sim_gpio_output_level(range_gpio[i]);
+    if (range_reference_ohms[i] > 0.0f && level >= 0) {
+      if (level) {
+        to_vdd += 1.0f / range_reference_ohms[i];
+      } else {
+        to_gnd += 1.0f / range_reference_ohms[i];
+      }
+    }
+  }
+
+  float code = 4095.0f * to_vdd / (to_vdd + to_gnd);
+  code = gain * code + offset_lsb;
+  if (noise_lsb > 0.0f) {
+    code += noise_lsb * sim_adc_gaussian();
+  }
+
+  // Códigos mais largos deslocam para baixo todos os seguintes
+  if (dnl_lsb > 0.0f) {
+    for (int spike = 512; spike < 4096; spike += 1024) {
+      if (code >= spike + 0.5f + dnl_lsb) {
+        code -= dnl_lsb;
+      } else if (code >= spike - 0.5f) {
+        code = (float)spike;
+      }
+    }
+  }
+
+  if (code < 0.0f) {
+    return 0;
+  }
+  if (code > 4095.0f) {
+    return 4095;
+  }
+  return (uint16_t)lrintf(code);
+}
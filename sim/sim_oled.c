@@ -0,0 +1,185 @@
+#include <string.h>
+
+#include "sim/sim.h"
+
+// Emulação do SSD1306 128x64: interpreta os bytes de controle (0x80/0x00 =>
+// comando, 0x40 => dados), os comandos de endereçamento e grava os dados em
+// uma GDDRAM em memória organizada em páginas de 8 linhas.
+#define SIM_OLED_WIDTH 128
+#define SIM_OLED_PAGES 8
+
+static uint8_t gddram[SIM_OLED_PAGES][SIM_OLED_WIDTH];
+static sim_oled_stats_t stats;
+
+// Estado do endereçamento (SET_MEM_ADDR, SET_COL_ADDR e SET_PAGE_ADDR)
+static uint8_t addr_mode = 0x02;
+static uint8_t col_start = 0, col_end = SIM_OLED_WIDTH - 1, col = 0;
+static uint8_t page_start = 0, page_end = SIM_OLED_PAGES - 1, page = 0;
+
+// Comando aguardando argumentos
+static uint8_t pending_cmd = 0;
+static uint8_t pending_args = 0;
+static uint8_t args[2];
+static uint8_t args_len = 0;
+
+static uint8_t sim_oled_arg_count(uint8_t cmd) {
+  switch (cmd) {
+    case 0x21: // SET_COL_ADDR
+    case 0x22: // SET_PAGE_ADDR
+      return 2;
+    case 0x20: // SET_MEM_ADDR
+    case 0x81: // SET_CONTRAST
+    case 0xA8: // SET_MUX_RATIO
+    case 0xD3: // SET_DISP_OFFSET
+    case 0xDA: // SET_COM_PIN_CFG
+    case 0xD5: // SET_DISP_CLK_DIV
+    case 0xD9: // SET_PRECHARGE
+    case 0xDB: // SET_VCOM_DESEL
+    case 0x8D: // SET_CHARGE_PUMP
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+static void sim_oled_execute(uint8_t cmd) {
+  switch (cmd) {
+    case 0x20:
+      addr_mode = args[0] & 0x03;
+      break;
+    case 0x21:
+      col_start = col = args[0] & 0x7F;
+      col_end = args[1] & 0x7F;
+      break;
+    case 0x22:
+      page_start = page = args[0] & 0x07;
+      page_end = args[1] & 0x07;
+      break;
+    default:
+      break;
+  }
+}
+
+static void sim_oled_command_byte(uint8_t byte) {
+  if (pending_args) {
+    args[args_len++] = byte;
+    if (--pending_args == 0) {
+      sim_oled_execute(pending_cmd);
+    }
+    return;
+  }
+
+  pending_cmd = byte;
+  args_len = 0;
+  pending_args = sim_oled_arg_count(byte);
+  if (!pending_args) {
+    sim_oled_execute(byte);
+  }
+}
+
+static void sim_oled_data_byte(uint8_t byte) {
+  gddram[page][col] = byte;
+
+  if (addr_mode == 0x01) {
+    // Endereçamento vertical: percorre as páginas e depois avança a coluna
+    if (page++ >= page_end) {
+      page = page_start;
+      col = (col >= col_end) ? col_start : col + 1;
+    }
+  } else {
+    // Endereçamento horizontal (e de página): percorre as colunas
+    if (col++ >= col_end) {
+      col = col_start;
+      if (addr_mode == 0x00) {
+        page = (page >= page_end) ? page_start : page + 1;
+      }
+    }
+  }
+}
+
+void sim_oled_i2c_write(uint8_t address, const uint8_t *src, size_t len, uint32_t baudrate) {
+  (void)address;
+
+  stats.transactions++;
+  stats.bytes += len;
+  if (baudrate) {
+    // endereço + bytes, 9 bits cada (8 bits + ACK)
+    stats.bus_time_us += ((uint64_t)(len + 1) * 9u * 1000000u) / baudrate;
+  }
+
+  size_t i = 0;
+  while (i < len) {
+    uint8_t control = src[i++];
+    bool continuation = control & 0x80; // Co = 1 => apenas um byte segue
+    bool data = control & 0x40;         // D/C#
+
+    if (data) {
+      stats.frames++;
+    }
+
+    if (continuation) {
+      if (i < len) {
+        if (data) {
+          sim_oled_data_byte(src[i]);
+        } else {
+          sim_oled_command_byte(src[i]);
+        }
+        i++;
+      }
+      continue;
+    }
+
+    for (; i < len; i++) {
+      if (data) {
+        sim_oled_data_byte(src[i]);
+      } else {
+        sim_oled_command_byte(src[i]);
+      }
+    }
+  }
+}
+
+bool sim_oled_pixel(uint8_t x, uint8_t y) {
+  if (x >= SIM_OLED_WIDTH || y >= SIM_OLED_PAGES * 8) {
+    return false;
+  }
+  return (gddram[y >> 3][x] >> (y & 0x07)) & 0x01;
+}
+
+void sim_oled_get_stats(sim_oled_stats_t *out) {
+  *out = stats;
+}
+
+void sim_oled_reset_stats(void) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+void sim_oled_dump(FILE *out) {
+  // Duas linhas do display por linha de texto
+  for (uint8_t y = 0; y < SIM_OLED_PAGES * 8; y += 2) {
+    for (uint8_t x = 0; x < SIM_OLED_WIDTH; x++) {
+      bool top = sim_oled_pixel(x, y);
+      bool bottom = sim_oled_pixel(x, y + 1);
+      fputc(top ? (bottom ? ':' : '\'') : (bottom ? '.' : ' '), out);
+    }
+    fputc('\n', out);
+  }
+}
+
+bool sim_oled_write_pbm(const char *path) {
+  FILE *out = fopen(path, "w");
+  if (!out) {
+    return false;
+  }
+
+  fprintf(out, "P1\n%d %d\n", SIM_OLED_WIDTH, SIM_OLED_PAGES * 8);
+  for (uint8_t y = 0; y < SIM_OLED_PAGES * 8; y++) {
+    for (uint8_t x = 0; x < SIM_OLED_WIDTH; x++) {
+      fputc(sim_oled_pixel(x, y) ? '1' : '0', out);
+    }
+    fputc('\n', out);
+  }
+
+  fclose(out);
+  return true;
+}
@@ -0,0 +1,141 @@
+#include <string.h>
+
+#include "src/adc_filter.h"
+
+#define ADC_FILTER_EWMA_FRAC_BITS 8
+
+void adc_filter_init(adc_filter_t *filter, const adc_filter_config_t *config) {
+  filter->config = *config;
+  if (filter->config.window == 0) filter->config.window = 1;
+  if (filter->config.window > ADC_FILTER_WINDOW_MAX) filter->config.window = ADC_FILTER_WINDOW_MAX;
+  if (2 * filter->config.trim >= filter->config.window) filter->config.trim = (filter->config.window - 1) / 2;
+
+  filter->output = 0;
+  adc_filter_reset(filter);
+}
+
+void adc_filter_reset(adc_filter_t *filter) {
+  filter->block_sum = 0;
+  filter->block_count = 0;
+  filter->head = 0;
+  filter->count = 0;
+  filter->sum = 0;
+  filter->sum_sq = 0;
+  filter->ewma_valid = false;
+  filter->outliers = 0;
+  filter->stable = false;
+}
+
+// Posição do primeiro elemento >= value na janela ordenada
+static uint8_t adc_filter_lower_bound(const adc_filter_t *filter, uint32_t value) {
+  uint8_t low = 0, high = filter->count;
+  while (low < high) {
+    uint8_t mid = (low + high) / 2;
+    if (filter->sorted[mid] < value) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+static void adc_filter_sorted_remove(adc_filter_t *filter, uint32_t value) {
+  uint8_t pos = adc_filter_lower_bound(filter, value);
+  memmove(&filter->sorted[pos], &filter->sorted[pos + 1], (filter->count - pos - 1) * sizeof(uint32_t));
+}
+
+static void adc_filter_sorted_insert(adc_filter_t *filter, uint32_t value) {
+  uint8_t pos = adc_filter_lower_bound(filter, value);
+  memmove(&filter->sorted[pos + 1], &filter->sorted[pos], (filter->count - pos) * sizeof(uint32_t));
+  filter->sorted[pos] = value;
+}
+
+static uint32_t adc_filter_median(const adc_filter_t *filter) {
+  uint8_t mid = filter->count / 2;
+  if (filter->count & 1) {
+    return filter->sorted[mid];
+  }
+  return (filter->sorted[mid - 1] + filter->sorted[mid] + 1) / 2;
+}
+
+static uint32_t adc_filter_center(const adc_filter_t *filter) {
+  if (filter->config.mode == ADC_FILTER_MEDIAN) {
+    return adc_filter_median(filter);
+  }
+
+  // Média aparada: só descarta extremos quando a janela já está cheia
+  uint8_t trim = (filter->count == filter->config.window) ? filter->config.trim : 0;
+  uint8_t kept = filter->count - 2 * trim;
+  uint32_t sum = 0;
+  for (uint8_t i = trim; i < filter->count - trim; i++) {
+    sum += filter->sorted[i];
+  }
+  return (sum + kept / 2) / kept;
+}
+
+static void adc_filter_add_block(adc_filter_t *filter, uint32_t value) {
+  const adc_filter_config_t *config = &filter->config;
+
+  // Rejeição de blocos distantes da mediana (contato intermitente, ruído impulsivo)
+  if (config->outlier_lsb && filter->count >= 3) {
+    uint32_t median = adc_filter_median(filter);
+    uint32_t distance = value > median ? value - median : median - value;
+
+    if (distance > (uint32_t)config->outlier_lsb * ADC_FILTER_BLOCK_SAMPLES) {
+      if (++filter->outliers < config->outlier_limit) {
+        return;
+      }
+      // Desvio persistente: o valor medido mudou de fato
+      adc_filter_reset(filter);
+    }
+  }
+  filter->outliers = 0;
+
+  // Janela cheia: sai o bloco mais antigo
+  if (filter->count == config->window) {
+    uint32_t oldest = filter->ring[filter->head];
+    adc_filter_sorted_remove(filter, oldest);
+    filter->count--;
+    filter->sum -= oldest;
+    filter->sum_sq -= (uint64_t)oldest * oldest;
+  }
+
+  adc_filter_sorted_insert(filter, value);
+  filter->ring[filter->head] = value;
+  filter->head = (filter->head + 1) % config->window;
+  filter->count++;
+  filter->sum += value;
+  filter->sum_sq += (uint64_t)value * value;
+
+  uint32_t center = adc_filter_center(filter);
+
+  if (config->ewma_shift && filter->ewma_valid) {
+    int64_t target = (int64_t)center << ADC_FILTER_EWMA_FRAC_BITS;
+    filter->ewma += (int32_t)((target - (int64_t)filter->ewma) / (1 << config->ewma_shift));
+  } else {
+    filter->ewma = center << ADC_FILTER_EWMA_FRAC_BITS;
+    filter->ewma_valid = true;
+  }
+  filter->output = (filter->ewma + (1u << (ADC_FILTER_EWMA_FRAC_BITS - 1))) >> ADC_FILTER_EWMA_FRAC_BITS;
+
+  // Estável: janela cheia e n * soma(x^2) - soma(x)^2 <= (n * desvio)^2
+  uint64_t n = filter->count;
+  uint64_t spread = n * filter->sum_sq - filter->sum * filter->sum;
+  uint64_t limit = n * (uint64_t)config->stable_lsb * ADC_FILTER_BLOCK_SAMPLES;
+  filter->stable = filter->count == config->window && spread <= limit * limit;
+}
+
+bool adc_filter_push(adc_filter_t *filter, uint16_t sample) {
+  filter->block_sum += sample;
+  if (++filter->block_count < ADC_FILTER_BLOCK_SAMPLES) {
+    return false;
+  }
+
+  uint32_t value = filter->block_sum;
+  filter->block_sum = 0;
+  filter->block_count = 0;
+
+  adc_filter_add_block(filter, value);
+  return true;
+}
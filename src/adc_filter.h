@@ -0,0 +1,88 @@
+#ifndef ADC_FILTER_H
+#define ADC_FILTER_H
+
+/*
+ * Filtro robusto das amostras do ADC.
+ *
+ * As amostras são agrupadas em blocos de ADC_FILTER_BLOCK_SAMPLES (apenas a
+ * soma é guardada). As somas dos últimos blocos formam uma janela de tamanho
+ * fixo, mantida também ordenada, sobre a qual são calculados:
+ *  - a mediana ou a média aparada (descarta os extremos);
+ *  - a variância (somas acumuladas), que define o estado "estável";
+ *  - a rejeição de blocos muito distantes da mediana. Vários blocos distantes
+ *    seguidos indicam uma mudança real (outro resistor): a janela recomeça.
+ * O resultado ainda pode ser suavizado por uma média móvel exponencial (EWMA).
+ *
+ * Custo: O(1) por amostra; por bloco, busca binária e um deslocamento curto
+ * na janela ordenada (até ADC_FILTER_WINDOW_MAX elementos).
+ *
+ * Os valores do filtro estão na escala de "soma de um bloco", ou seja,
+ * média * ADC_FILTER_BLOCK_SAMPLES, prontos para resistor_from_adc_sum().
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ADC_FILTER_BLOCK_SAMPLES 32
+#define ADC_FILTER_WINDOW_MAX 32
+
+typedef enum {
+  ADC_FILTER_MEDIAN,
+  ADC_FILTER_TRIMMED_MEAN
+} adc_filter_mode_t;
+
+typedef struct {
+  adc_filter_mode_t mode;
+  uint8_t window;          // blocos na janela (1..ADC_FILTER_WINDOW_MAX)
+  uint8_t trim;            // blocos descartados em cada extremo na média aparada
+  uint8_t ewma_shift;      // peso da EWMA = 1 / 2^ewma_shift (0 = sem EWMA)
+  uint16_t outlier_lsb;    // distância máxima da mediana, em LSB da média do bloco (0 = sem rejeição)
+  uint8_t outlier_limit;   // blocos rejeitados seguidos que reiniciam a janela
+  uint16_t stable_lsb;     // desvio padrão máximo da janela para considerá-la estável (LSB)
+} adc_filter_config_t;
+
+typedef struct {
+  adc_filter_config_t config;
+
+  uint32_t block_sum;
+  uint16_t block_count;
+
+  uint32_t ring[ADC_FILTER_WINDOW_MAX];    // blocos na ordem de chegada
+  uint32_t sorted[ADC_FILTER_WINDOW_MAX];  // os mesmos blocos, ordenados
+  uint8_t head;
+  uint8_t count;
+
+  uint64_t sum;      // soma e soma dos quadrados da janela (variância)
+  uint64_t sum_sq;
+
+  uint32_t ewma;     // EWMA com 8 bits fracionários
+  bool ewma_valid;
+
+  uint8_t outliers;  // blocos rejeitados seguidos
+  uint32_t output;
+  bool stable;
+} adc_filter_t;
+
+void adc_filter_init(adc_filter_t *filter, const adc_filter_config_t *config);
+
+// Descarta a janela (ex.: troca de faixa de medição)
+void adc_filter_reset(adc_filter_t *filter);
+
+// Processa uma amostra. Retorna true quando um bloco foi concluído e a saída atualizada.
+bool adc_filter_push(adc_filter_t *filter, uint16_t sample);
+
+// Saída filtrada (média * ADC_FILTER_BLOCK_SAMPLES) e blocos considerados
+static inline uint32_t adc_filter_output(const adc_filter_t *filter) {
+  return filter->output;
+}
+
+static inline uint8_t adc_filter_blocks(const adc_filter_t *filter) {
+  return filter->count;
+}
+
+// Janela cheia e com variância abaixo do limite
+static inline bool adc_filter_stable(const adc_filter_t *filter) {
+  return filter->stable;
+}
+
+#endif // ADC_FILTER_H
@@ -0,0 +1,99 @@
+#include "src/adc_stream.h"
+
+#define ADC_STREAM_MASK (ADC_STREAM_SIZE - 1)
+
+// O modo ring do DMA exige alinhamento ao tamanho do buffer em bytes
+static volatile uint16_t adc_stream_ring[ADC_STREAM_SIZE]
+  __attribute__((aligned(ADC_STREAM_SIZE * sizeof(uint16_t))));
+
+static uint32_t adc_stream_read_index = 0;
+static bool adc_stream_running = false;
+static hal_adc_callback_t adc_stream_ready_callback = NULL;
+static void *adc_stream_ready_arg = NULL;
+
+// Detecção de transbordamento: amostras não lidas na última consulta e o
+// instante dela. O índice de escrita só é conhecido módulo o tamanho do
+// buffer, então o que o DMA gravou desde então é estimado pela taxa.
+static uint32_t adc_stream_rate = 0;
+static uint32_t adc_stream_unread = 0;
+static uint64_t adc_stream_checked_us = 0;
+static uint32_t adc_stream_overrun_count = 0;
+
+void adc_stream_set_ready_callback(hal_adc_callback_t callback, void *arg) {
+  adc_stream_ready_callback = callback;
+  adc_stream_ready_arg = arg;
+}
+
+bool adc_stream_start(uint input, uint32_t sample_rate_hz) {
+  if (adc_stream_running) {
+    return false;
+  }
+
+  adc_stream_read_index = 0;
+  adc_stream_rate = sample_rate_hz;
+  adc_stream_unread = 0;
+  adc_stream_checked_us = hal_time_us();
+  adc_stream_running = hal_adc_stream_start(input, sample_rate_hz, adc_stream_ring, ADC_STREAM_RING_BITS,
+                                            ADC_STREAM_BLOCK_BITS, adc_stream_ready_callback,
+                                            adc_stream_ready_arg);
+  return adc_stream_running;
+}
+
+void adc_stream_stop(void) {
+  if (adc_stream_running) {
+    hal_adc_stream_stop();
+    adc_stream_running = false;
+  }
+}
+
+bool adc_stream_active(void) {
+  return adc_stream_running;
+}
+
+uint32_t adc_stream_available(void) {
+  if (!adc_stream_running) {
+    return 0;
+  }
+
+  uint64_t now_us = hal_time_us();
+  uint32_t write_index = hal_adc_stream_write_index();
+  uint64_t written = (now_us - adc_stream_checked_us) * adc_stream_rate / 1000000u;
+
+  // O DMA deu a volta sobre amostras não lidas (ex.: consumidor parado por
+  // mais de 410 ms): a diferença dos índices não tem mais sentido. Retoma a
+  // leitura da posição atual.
+  if (adc_stream_unread + written >= ADC_STREAM_SIZE) {
+    adc_stream_read_index = write_index;
+    adc_stream_overrun_count++;
+  }
+
+  adc_stream_unread = (write_index - adc_stream_read_index) & ADC_STREAM_MASK;
+  adc_stream_checked_us = now_us;
+  return adc_stream_unread;
+}
+
+uint32_t adc_stream_overruns(void) {
+  return adc_stream_overrun_count;
+}
+
+uint32_t adc_stream_read(uint16_t *dst, uint32_t max) {
+  uint32_t count = adc_stream_available();
+  if (count > max) {
+    count = max;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    dst[i] = adc_stream_ring[adc_stream_read_index];
+    adc_stream_read_index = (adc_stream_read_index + 1) & ADC_STREAM_MASK;
+  }
+  adc_stream_unread -= count;
+  return count;
+}
+
+void adc_stream_discard(void) {
+  if (adc_stream_running) {
+    adc_stream_read_index = hal_adc_stream_write_index();
+    adc_stream_unread = 0;
+    adc_stream_checked_us = hal_time_us();
+  }
+}
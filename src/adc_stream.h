@@ -0,0 +1,54 @@
+#ifndef ADC_STREAM_H
+#define ADC_STREAM_H
+
+/*
+ * Aquisição contínua do ADC.
+ *
+ * O ADC roda em modo free-running e o DMA grava as amostras em um buffer
+ * circular (hal_adc_stream_*). Este módulo é o único consumidor do buffer:
+ * a posição de escrita vem do DMA (produtor) e a de leitura é mantida aqui,
+ * portanto não há necessidade de travas (produtor único / consumidor único).
+ *
+ * O consumidor deve ler com frequência suficiente para não ser ultrapassado
+ * pelo DMA: ADC_STREAM_SIZE / taxa de amostragem (410 ms a 10 kHz).
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hal/hal.h"
+
+// Buffer circular de 2^ADC_STREAM_RING_BITS amostras de 16 bits
+#define ADC_STREAM_RING_BITS 12
+#define ADC_STREAM_SIZE (1u << ADC_STREAM_RING_BITS)
+
+// Blocos de 2^ADC_STREAM_BLOCK_BITS amostras: ao fim de cada um o DMA gera a
+// interrupção de amostras prontas (a cada 102 ms a 10 kHz)
+#define ADC_STREAM_BLOCK_BITS 10
+
+// Callback chamado em interrupção a cada bloco de amostras gravado. Vale a
+// partir da próxima adc_stream_start.
+void adc_stream_set_ready_callback(hal_adc_callback_t callback, void *arg);
+
+// Inicia a captura do canal informado. Retorna false se já estiver ativa.
+bool adc_stream_start(uint input, uint32_t sample_rate_hz);
+void adc_stream_stop(void);
+
+// Indica se a captura está ativa (adc_stream_start teve sucesso)
+bool adc_stream_active(void);
+
+// Quantidade de amostras novas ainda não consumidas. Se o DMA passou por
+// cima de amostras não lidas, elas são descartadas e a contagem recomeça da
+// posição atual (adc_stream_overruns).
+uint32_t adc_stream_available(void);
+
+// Vezes em que o consumidor foi ultrapassado pelo DMA
+uint32_t adc_stream_overruns(void);
+
+// Copia até max amostras para dst, na ordem de aquisição. Retorna a quantidade copiada.
+uint32_t adc_stream_read(uint16_t *dst, uint32_t max);
+
+// Descarta as amostras já capturadas (ex.: após trocar a faixa de medição)
+void adc_stream_discard(void);
+
+#endif // ADC_STREAM_H
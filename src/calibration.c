@@ -0,0 +1,212 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "src/adc_stream.h"
+#include "src/calibration.h"
+#include "src/crc32.h"
+#include "src/resistor.h"
+
+#define CALIBRATION_MAGIC 0x4C414331u // "CAL1"
+#define CALIBRATION_VERSION 1
+
+#define CALIBRATION_GAIN_ONE (1u << 16)
+
+uint16_t calibration_lut[HAL_ADC_MAX_VALUE + 1];
+
+static calibration_t calibration = {
+  .magic = CALIBRATION_MAGIC,
+  .version = CALIBRATION_VERSION,
+  .gain_q16 = CALIBRATION_GAIN_ONE,
+};
+
+// 0 = nenhuma, 1 = offset e ganho, 2 = offset, ganho e DNL
+static volatile uint8_t calibration_requested = 0;
+
+// Página gravada na flash (hal_flash_program exige a origem na RAM)
+static uint8_t calibration_page[HAL_FLASH_PAGE_SIZE];
+
+// Deslocamento (Q8) que leva o código lido ao centro do seu degrau real
+static int32_t calibration_dnl_q8(uint16_t raw) {
+  int32_t correction = 0;
+
+  for (uint32_t spike = 512; spike <= HAL_ADC_MAX_VALUE; spike += 1024) {
+    if (raw > spike) {
+      correction += CALIBRATION_DNL_SPIKE_LSB << 8;
+    } else if (raw == spike) {
+      correction += CALIBRATION_DNL_SPIKE_LSB << 7;
+    }
+  }
+  return correction;
+}
+
+static void calibration_build_lut(const calibration_t *cal) {
+  bool dnl = cal->flags & CALIBRATION_FLAG_DNL;
+
+  for (uint32_t raw = 0; raw <= HAL_ADC_MAX_VALUE; raw++) {
+    int64_t code_q8 = ((int64_t)raw << 8) + (dnl ? calibration_dnl_q8(raw) : 0);
+
+    // ideal = (leitura - offset) / ganho
+    int64_t ideal_q8 = (code_q8 - cal->offset_q8) * CALIBRATION_GAIN_ONE / cal->gain_q16;
+    int64_t ideal = ideal_q8 > 0 ? (ideal_q8 + 128) >> 8 : 0;
+
+    // Só a saturação real continua indicando circuito aberto
+    if (raw == HAL_ADC_MAX_VALUE) {
+      ideal = HAL_ADC_MAX_VALUE;
+    } else if (ideal > HAL_ADC_MAX_VALUE - 1) {
+      ideal = HAL_ADC_MAX_VALUE - 1;
+    }
+    calibration_lut[raw] = (uint16_t)ideal;
+  }
+}
+
+static bool calibration_valid(const calibration_t *cal) {
+  return cal->magic == CALIBRATION_MAGIC &&
+         cal->version == CALIBRATION_VERSION &&
+         cal->gain_q16 != 0 &&
+         cal->crc == crc32(cal, offsetof(calibration_t, crc));
+}
+
+void calibration_init(void) {
+  calibration_t stored;
+  memcpy(&stored, hal_flash_data() + CALIBRATION_FLASH_OFFSET, sizeof(stored));
+
+  if (calibration_valid(&stored)) {
+    calibration = stored;
+  } else {
+    printf("Sem calibração gravada, usando o ADC sem correção\n");
+  }
+  calibration_build_lut(&calibration);
+}
+
+void calibration_request(bool dnl) {
+  calibration_requested = dnl ? 2 : 1;
+}
+
+bool calibration_pending(void) {
+  return calibration_requested != 0;
+}
+
+const calibration_t *calibration_current(void) {
+  return &calibration;
+}
+
+// Liga a referência da faixa high ao 3.3V e a da faixa low ao GND (-1 = nenhuma),
+// deixando as demais em alta impedância
+static void calibration_drive(int8_t high, int8_t low) {
+  for (int8_t i = 0; i < RESISTOR_RANGE_COUNT; i++) {
+    if (i != high && i != low) {
+      hal_gpio_init_input(resistor_ranges[i].gpio);
+    }
+  }
+  if (low >= 0) {
+    hal_gpio_init_output(resistor_ranges[low].gpio);
+    hal_gpio_put(resistor_ranges[low].gpio, false);
+  }
+  if (high >= 0) {
+    hal_gpio_init_output(resistor_ranges[high].gpio);
+    hal_gpio_put(resistor_ranges[high].gpio, true);
+  }
+}
+
+// Média (Q8) de CALIBRATION_POINT_SAMPLES amostras com a configuração indicada
+static int32_t calibration_measure_point(int8_t high, int8_t low, bool dnl) {
+  calibration_drive(high, low);
+  hal_sleep_ms(CALIBRATION_SETTLE_MS);
+  adc_stream_discard();
+
+  uint16_t chunk[64];
+  uint32_t total = 0;
+  int64_t sum_q8 = 0;
+
+  while (total < CALIBRATION_POINT_SAMPLES) {
+    uint32_t max = CALIBRATION_POINT_SAMPLES - total;
+    uint32_t count = adc_stream_read(chunk, max < 64 ? max : 64);
+    for (uint32_t i = 0; i < count; i++) {
+      sum_q8 += ((int32_t)chunk[i] << 8) + (dnl ? calibration_dnl_q8(chunk[i]) : 0);
+    }
+    total += count;
+
+    if (!count) {
+      hal_sleep_ms(1);
+    }
+  }
+  return (int32_t)(sum_q8 / CALIBRATION_POINT_SAMPLES);
+}
+
+static bool calibration_save(calibration_t *cal) {
+  cal->crc = crc32(cal, offsetof(calibration_t, crc));
+
+  memset(calibration_page, 0xFF, sizeof(calibration_page));
+  memcpy(calibration_page, cal, sizeof(*cal));
+
+  return hal_flash_erase(CALIBRATION_FLASH_OFFSET, HAL_FLASH_SECTOR_SIZE) &&
+         hal_flash_program(CALIBRATION_FLASH_OFFSET, calibration_page, sizeof(calibration_page)) &&
+         memcmp(hal_flash_data() + CALIBRATION_FLASH_OFFSET, cal, sizeof(*cal)) == 0;
+}
+
+// Pontos de calibração, todos com as pontas abertas:
+//  - zero: uma referência ligada ao GND, o nó fica em 0 V;
+//  - pares complementares: a referência a em nível alto e b em nível baixo, e
+//    o inverso. As tensões dos dois divisores somam exatamente o fundo de
+//    escala, qualquer que seja a tolerância dos resistores, então a soma das
+//    leituras de cada par vale ganho * 4095 + 2 * offset.
+static calibration_status_t calibration_fit(bool dnl, calibration_t *cal) {
+  // Sem resistor, a maior referência sozinha leva o nó ao 3.3V
+  int32_t open_q8 = calibration_measure_point(RESISTOR_RANGE_COUNT - 1, -1, dnl);
+  if (open_q8 < (CALIBRATION_OPEN_MIN_LSB << 8)) {
+    return CALIBRATION_ERROR_NOT_OPEN;
+  }
+
+  int32_t offset_q8 = calibration_measure_point(-1, 0, dnl);
+
+  int64_t pair_sum_q8 = 0;
+  for (int8_t i = 0; i + 1 < RESISTOR_RANGE_COUNT; i++) {
+    pair_sum_q8 += calibration_measure_point(i, i + 1, dnl);
+    pair_sum_q8 += calibration_measure_point(i + 1, i, dnl);
+  }
+
+  const int64_t pairs = RESISTOR_RANGE_COUNT - 1;
+  int64_t full_scale_q8 = pair_sum_q8 - 2 * pairs * offset_q8;
+  uint32_t gain_q16 = (uint32_t)(full_scale_q8 * CALIBRATION_GAIN_ONE / (pairs * ((int64_t)HAL_ADC_MAX_VALUE << 8)));
+
+  int32_t gain_error = (int32_t)gain_q16 - (int32_t)CALIBRATION_GAIN_ONE;
+  if (offset_q8 > (CALIBRATION_MAX_OFFSET_LSB << 8) || offset_q8 < -(CALIBRATION_MAX_OFFSET_LSB << 8) ||
+      gain_error > (int32_t)((uint64_t)CALIBRATION_GAIN_ONE * CALIBRATION_MAX_GAIN_ERROR_PPM / 1000000u) ||
+      gain_error < -(int32_t)((uint64_t)CALIBRATION_GAIN_ONE * CALIBRATION_MAX_GAIN_ERROR_PPM / 1000000u)) {
+    return CALIBRATION_ERROR_FIT;
+  }
+
+  cal->magic = CALIBRATION_MAGIC;
+  cal->version = CALIBRATION_VERSION;
+  cal->flags = dnl ? CALIBRATION_FLAG_DNL : 0;
+  cal->offset_q8 = offset_q8;
+  cal->gain_q16 = gain_q16;
+  return CALIBRATION_OK;
+}
+
+calibration_status_t calibration_run(void) {
+  bool dnl = calibration_requested == 2;
+  calibration_requested = 0;
+
+  calibration_t result;
+  calibration_status_t status = calibration_fit(dnl, &result);
+
+  if (status == CALIBRATION_OK) {
+    if (calibration_save(&result)) {
+      calibration = result;
+      calibration_build_lut(&calibration);
+      printf("Calibração: offset %ld/256 LSB, ganho %lu/65536%s\n",
+             (long)calibration.offset_q8, (unsigned long)calibration.gain_q16, dnl ? ", com DNL" : "");
+    } else {
+      status = CALIBRATION_ERROR_FLASH;
+    }
+  }
+  if (status != CALIBRATION_OK) {
+    printf("Calibração falhou (%d)\n", (int)status);
+  }
+
+  // Volta à faixa em uso, descartando o que o filtro acumulou
+  resistor_select_range(resistor_range());
+  return status;
+}
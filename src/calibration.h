@@ -0,0 +1,91 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+/*
+ * Calibração do ADC (offset, ganho e, opcionalmente, DNL).
+ *
+ * Com as pontas abertas (sem resistor), os próprios resistores de referência
+ * formam divisores conhecidos: o GPIO de uma faixa em nível alto e o de outra
+ * em nível baixo. O ponto de zero (uma referência ligada ao GND) e os pares
+ * complementares de divisores determinam o modelo
+ *   leitura = ganho * ideal + offset
+ * sem depender da tolerância dos resistores (ver calibration_fit).
+ *
+ * A correção de DNL, opcional, compensa os códigos 512, 1536, 2560 e 3584 do
+ * ADC do RP2040, mais largos que os demais: cada um desloca os códigos acima
+ * dele em CALIBRATION_DNL_SPIKE_LSB. Ela é aplicada às amostras antes do
+ * ajuste de offset e ganho.
+ *
+ * O resultado é gravado em um setor reservado da flash. Na inicialização e
+ * após cada calibração ele é convertido em uma tabela com o código corrigido
+ * de cada código do ADC, de modo que no caminho de medição a correção é uma
+ * única consulta por amostra (calibration_apply).
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hal/hal.h"
+
+// Setor da área de dados da flash (hal_flash_*) usado pela calibração
+#define CALIBRATION_FLASH_OFFSET 0
+
+// Largura extra aproximada de cada pico de DNL do ADC do RP2040
+#define CALIBRATION_DNL_SPIKE_LSB 8
+
+// Amostras por ponto de calibração e tempo de acomodação após trocar os pinos
+#define CALIBRATION_POINT_SAMPLES 2048
+#define CALIBRATION_SETTLE_MS 5
+
+// A calibração de fábrica de um RP2040 fica bem dentro destes limites;
+// ajustes fora deles indicam um ponto medido com resistor nas pontas
+#define CALIBRATION_MAX_OFFSET_LSB 64
+#define CALIBRATION_MAX_GAIN_ERROR_PPM 50000
+
+// Sem resistor, a maior referência sozinha leva o nó a pelo menos este código
+#define CALIBRATION_OPEN_MIN_LSB 3900
+
+#define CALIBRATION_FLAG_DNL 0x1u
+
+// Registro gravado na flash
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t flags;      // CALIBRATION_FLAG_*
+  int32_t offset_q8;   // offset do ADC em LSB, com 8 bits fracionários
+  uint32_t gain_q16;   // ganho do ADC com 16 bits fracionários
+  uint32_t crc;        // CRC-32 dos campos anteriores
+} calibration_t;
+
+typedef enum {
+  CALIBRATION_OK = 0,
+  CALIBRATION_ERROR_NOT_OPEN,   // havia um resistor nas pontas
+  CALIBRATION_ERROR_FIT,        // ajuste fora dos limites esperados
+  CALIBRATION_ERROR_FLASH       // falha ao gravar a flash
+} calibration_status_t;
+
+// Código corrigido para cada código do ADC
+extern uint16_t calibration_lut[HAL_ADC_MAX_VALUE + 1];
+
+// Carrega a calibração da flash (ou usa a identidade) e monta a tabela
+void calibration_init(void);
+
+// Pede uma calibração ao núcleo de medição. Pode ser chamada em interrupção
+// ou pelo outro núcleo.
+void calibration_request(bool dnl);
+
+bool calibration_pending(void);
+
+// Executa a calibração pedida (núcleo de medição, com as pontas abertas),
+// grava o resultado e atualiza a tabela. Ao terminar, a faixa ativa é
+// restaurada.
+calibration_status_t calibration_run(void);
+
+// Calibração em uso
+const calibration_t *calibration_current(void);
+
+static inline uint16_t calibration_apply(uint16_t raw) {
+  return calibration_lut[raw & HAL_ADC_MAX_VALUE];
+}
+
+#endif // CALIBRATION_H
@@ -0,0 +1,14 @@
+#include "src/crc32.h"
+
+uint32_t crc32(const void *data, size_t len) {
+  const uint8_t *bytes = data;
+  uint32_t crc = 0xFFFFFFFFu;
+
+  for (size_t i = 0; i < len; i++) {
+    crc ^= bytes[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1u));
+    }
+  }
+  return ~crc;
+}
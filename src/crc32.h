@@ -0,0 +1,10 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-32 (polinômio 0xEDB88320, o mesmo do zlib) dos registros gravados na flash
+uint32_t crc32(const void *data, size_t len);
+
+#endif // CRC32_H
@@ -0,0 +1,106 @@
+#include <stdio.h>
+
+#include "src/display.h"
+#include "lib/ssd1306_ui.h"
+#include "src/metrics.h"
+#include "src/resistor.h"
+
+void draw_display_layout(ssd1306_t *ssd_ptr) {
+  // desenho dos contornos do layout do display
+  ssd1306_rect(ssd_ptr, 1, 1, 126, 62, 1, 0);
+  //cima
+  ssd1306_line(ssd_ptr, 5, 5, 5, 11, 1);
+  ssd1306_line(ssd_ptr, 6, 4, 10, 4, 1);
+  ssd1306_line(ssd_ptr, 10, 5, 20, 5, 1);
+  //baixo
+  ssd1306_line(ssd_ptr, 6, 12, 10, 12, 1);
+  ssd1306_line(ssd_ptr, 10, 11, 20, 11, 1);
+  //primeira faixa
+  ssd1306_line(ssd_ptr, 8, 4, 8, 12, 1);
+  ssd1306_line(ssd_ptr, 9, 4, 9, 12, 1);
+  //segunda faixa
+  ssd1306_line(ssd_ptr, 13, 5, 13, 11, 1);
+  ssd1306_line(ssd_ptr, 14, 5, 14, 11, 1);
+  //multiplicador
+  ssd1306_line(ssd_ptr, 17, 5, 17, 11, 1);
+  ssd1306_line(ssd_ptr, 18, 5, 18, 11, 1);
+  //tolerancia
+  ssd1306_line(ssd_ptr, 21, 5, 21, 11, 1);
+  ssd1306_line(ssd_ptr, 22, 5, 22, 11, 1);
+  //cima
+  ssd1306_line(ssd_ptr, 20, 4, 24, 4, 1);
+  ssd1306_line(ssd_ptr, 20, 12, 24, 12, 1);
+  ssd1306_line(ssd_ptr, 25, 5, 25, 11, 1);
+}
+
+// Desenho fixo da tela de medição: layout e rótulos
+static void draw_display_background(ssd1306_t *ssd_ptr) {
+  draw_display_layout(ssd_ptr);
+
+  // Rótulos das bandas (Tolerância Multiplicador Faixa_2 Faixa_1)
+  ssd1306_draw_string(ssd_ptr, "1=", 5, 20);
+  ssd1306_draw_string(ssd_ptr, "2=", 5, 31);
+  ssd1306_draw_string(ssd_ptr, "mult=", 5, 42);
+  ssd1306_draw_string(ssd_ptr, "tol=", 5, 52);
+  ssd1306_draw_string(ssd_ptr, "Au (5%)", 60, 52);
+}
+
+// Campos que mudam com a medição: valor comercial e cores de cada banda
+enum {
+  DISPLAY_FIELD_VALUE,
+  DISPLAY_FIELD_BAND_1,
+  DISPLAY_FIELD_BAND_2,
+  DISPLAY_FIELD_MULTIPLIER,
+  DISPLAY_FIELD_COUNT
+};
+
+static ssd1306_text_field_t display_fields[DISPLAY_FIELD_COUNT] = {
+  [DISPLAY_FIELD_VALUE]      = { .x = 29, .y = 5,  .max_chars = 12 },
+  [DISPLAY_FIELD_BAND_1]     = { .x = 60, .y = 20, .max_chars = 8 },
+  [DISPLAY_FIELD_BAND_2]     = { .x = 60, .y = 31, .max_chars = 8 },
+  [DISPLAY_FIELD_MULTIPLIER] = { .x = 60, .y = 42, .max_chars = 8 },
+};
+
+static ssd1306_scene_t display_scene;
+
+bool draw_display_measurement(ssd1306_t *ssd_ptr, const measurement_t *measurement) {
+  METRICS_SCOPE(METRICS_DISPLAY_DRAW);
+
+  // O fundo é desenhado uma única vez, na primeira medição
+  if (display_scene.ssd != ssd_ptr) {
+    ssd1306_scene_init(&display_scene, ssd_ptr, draw_display_background, display_fields, DISPLAY_FIELD_COUNT);
+  }
+
+  // Exibição do valor comercial da resistência mais próxima (o campo guarda
+  // uma cópia do texto)
+  char text[20];
+  snprintf(text, sizeof(text), "%lu ohms", (unsigned long)ohms_q8_round(measurement->e24));
+  ssd1306_text_field_set(&display_fields[DISPLAY_FIELD_VALUE], text);
+
+  // Exibição das cores de cada banda
+  ssd1306_text_field_set(&display_fields[DISPLAY_FIELD_BAND_1], resistor_band_color_name(measurement->bands[0]));
+  ssd1306_text_field_set(&display_fields[DISPLAY_FIELD_BAND_2], resistor_band_color_name(measurement->bands[1]));
+  ssd1306_text_field_set(&display_fields[DISPLAY_FIELD_MULTIPLIER], resistor_band_color_name(measurement->bands[2]));
+
+  // Só os campos alterados são redesenhados
+  ssd1306_scene_render(&display_scene);
+
+  // Envio por DMA: as tarefas seguem executando enquanto o display é
+  // atualizado. Com o envio anterior ainda em curso, as alterações ficam
+  // marcadas e cabe ao chamador tentar de novo.
+  return ssd1306_send_data_async(ssd_ptr);
+}
+
+void draw_display_message(ssd1306_t *ssd_ptr, const char *line_1, const char *line_2) {
+  ssd1306_fill(ssd_ptr, false);
+  draw_display_layout(ssd_ptr);
+  ssd1306_draw_string(ssd_ptr, line_1, 5, 24);
+  if (line_2) {
+    ssd1306_draw_string(ssd_ptr, line_2, 5, 36);
+  }
+  ssd1306_send_data(ssd_ptr);
+
+  if (display_scene.ssd) {
+    ssd1306_scene_invalidate(&display_scene);
+  }
+}
@@ -0,0 +1,21 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include "lib/ssd1306.h"
+#include "src/measurement.h"
+
+// Desenha o conteúdo fixo do display OLED (contorno e desenho do resistor)
+void draw_display_layout(ssd1306_t *ssd_ptr);
+
+// Atualiza a tela com o valor comercial e as cores das bandas e inicia o envio
+// ao display sem bloquear. Retorna false se o envio anterior não terminou: as
+// alterações seguem na próxima chamada, que o chamador deve garantir. O layout
+// fixo é desenhado só na primeira chamada e depois apenas os campos cujo texto
+// mudou são redesenhados.
+bool draw_display_measurement(ssd1306_t *ssd_ptr, const measurement_t *measurement);
+
+// Ocupa a tela com uma mensagem de até duas linhas (ex.: calibração) e a
+// envia de imediato. A próxima medição redesenha a tela inteira.
+void draw_display_message(ssd1306_t *ssd_ptr, const char *line_1, const char *line_2);
+
+#endif // DISPLAY_H
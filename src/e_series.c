@@ -0,0 +1,123 @@
+#include <string.h>
+
+#include "src/e_series.h"
+
+// Série E24 em 3 dígitos significativos
+static const uint16_t e24_values[24] = {
+  100, 110, 120, 130, 150, 160, 180, 200, 220, 240, 270, 300,
+  330, 360, 390, 430, 470, 510, 560, 620, 680, 750, 820, 910,
+};
+
+// Série E192. As séries E96 e E48 são exatamente os elementos de índice par e
+// múltiplo de 4 desta tabela, então são percorridas com passo 2 e 4.
+static const uint16_t e192_values[192] = {
+  100, 101, 102, 104, 105, 106, 107, 109, 110, 111, 113, 114,
+  115, 117, 118, 120, 121, 123, 124, 126, 127, 129, 130, 132,
+  133, 135, 137, 138, 140, 142, 143, 145, 147, 149, 150, 152,
+  154, 156, 158, 160, 162, 164, 165, 167, 169, 172, 174, 176,
+  178, 180, 182, 184, 187, 189, 191, 193, 196, 198, 200, 203,
+  205, 208, 210, 213, 215, 218, 221, 223, 226, 229, 232, 234,
+  237, 240, 243, 246, 249, 252, 255, 258, 261, 264, 267, 271,
+  274, 277, 280, 284, 287, 291, 294, 298, 301, 305, 309, 312,
+  316, 320, 324, 328, 332, 336, 340, 344, 348, 352, 357, 361,
+  365, 370, 374, 379, 383, 388, 392, 397, 402, 407, 412, 417,
+  422, 427, 432, 437, 442, 448, 453, 459, 464, 470, 475, 481,
+  487, 493, 499, 505, 511, 517, 523, 530, 536, 542, 549, 556,
+  562, 569, 576, 583, 590, 597, 604, 612, 619, 626, 634, 642,
+  649, 657, 665, 673, 681, 690, 698, 706, 715, 723, 732, 741,
+  750, 759, 768, 777, 787, 796, 806, 816, 825, 835, 845, 856,
+  866, 876, 887, 898, 909, 920, 931, 942, 953, 965, 976, 988,
+};
+
+// 10^k * 256: limites das décadas no formato Q24.8 (década d começa em índice d + 2)
+#define E_SERIES_DECADE_MIN (-2)
+#define E_SERIES_DECADE_MAX 6
+
+static const uint64_t e_series_pow10_q8[E_SERIES_DECADE_MAX - E_SERIES_DECADE_MIN + 2] = {
+  1ull * 256, 10ull * 256, 100ull * 256, 1000ull * 256, 10000ull * 256,
+  100000ull * 256, 1000000ull * 256, 10000000ull * 256, 100000000ull * 256,
+  1000000000ull * 256,
+};
+
+// Menor e maior valor tratados: 0,01 Ω e 10 MΩ
+#define E_SERIES_MIN_Q8 ((ohms_q8_t)((e_series_pow10_q8[0] + 99) / 100))
+#define E_SERIES_LIMIT_Q8 ((ohms_q8_t)(e_series_pow10_q8[E_SERIES_DECADE_MAX - E_SERIES_DECADE_MIN + 1] / 100))
+
+bool e_series_nearest(e_series_t series, ohms_q8_t ohms, e_series_match_t *match) {
+  memset(match, 0, sizeof(*match));
+  match->band_count = (series == E_SERIES_E24) ? 3 : 4;
+  match->bands[match->band_count - 1] = -1;
+
+  if (ohms < E_SERIES_MIN_Q8 || ohms >= E_SERIES_LIMIT_Q8) {
+    return false;
+  }
+
+  // Década d: 10^d <= ohms < 10^(d+1), comparando ohms * 100 com 10^(d+2) * 256
+  uint64_t scaled = (uint64_t)ohms * 100u;
+  int index = 0;
+  while (scaled >= e_series_pow10_q8[index + 1]) {
+    index++;
+  }
+  int decade = index + E_SERIES_DECADE_MIN;
+
+  // Mantissa em [100, 1000) com 16 bits fracionários: Q8 truncaria demais a
+  // comparação com a média geométrica perto dos limites entre valores
+  uint64_t mantissa = ((scaled * 100u) << 16) / e_series_pow10_q8[index];
+
+  const uint16_t *values = e192_values;
+  uint8_t stride = 1;
+  uint8_t count = 192;
+
+  switch (series) {
+    case E_SERIES_E24:  values = e24_values; count = 24; break;
+    case E_SERIES_E48:  stride = 4; count = 48; break;
+    case E_SERIES_E96:  stride = 2; count = 96; break;
+    case E_SERIES_E192: break;
+  }
+
+  // Busca binária do maior valor <= mantissa
+  uint8_t low = 0, high = count - 1;
+  while (low < high) {
+    uint8_t mid = (low + high + 1) / 2;
+    if ((uint64_t)values[mid * stride] << 16 <= mantissa) {
+      low = mid;
+    } else {
+      high = mid - 1;
+    }
+  }
+
+  // Entre o valor encontrado e o seguinte (1000 = 100 da década seguinte),
+  // o mais próximo em razão é decidido pela média geométrica: x^2 vs a*b
+  uint16_t below = values[low * stride];
+  uint16_t above = (low + 1 < count) ? values[(low + 1) * stride] : 1000;
+  uint16_t significand = below;
+
+  if (mantissa * mantissa >= ((uint64_t)below * above) << 32) {
+    significand = above;
+  }
+
+  if (significand == 1000) {
+    significand = 100;
+    decade++;
+  }
+
+  match->significand = significand;
+  match->decade = (int8_t)decade;
+  // Valor = significand * 10^(decade - 2), em Q8
+  match->value = (ohms_q8_t)(((uint64_t)significand * e_series_pow10_q8[decade - E_SERIES_DECADE_MIN]) / 10000u);
+
+  // Bandas: E24 usa 2 dígitos (último dígito de significand é sempre 0)
+  int multiplier;
+  if (series == E_SERIES_E24) {
+    match->bands[0] = significand / 100;
+    match->bands[1] = (significand / 10) % 10;
+    multiplier = decade - 1;
+  } else {
+    match->bands[0] = significand / 100;
+    match->bands[1] = (significand / 10) % 10;
+    match->bands[2] = significand % 10;
+    multiplier = decade - 2;
+  }
+  match->bands[match->band_count - 1] = (multiplier >= 0 && multiplier <= 9) ? multiplier : -1;
+  return true;
+}
@@ -0,0 +1,41 @@
+#ifndef E_SERIES_H
+#define E_SERIES_H
+
+/*
+ * Séries E de valores comerciais de resistores (IEC 60063).
+ *
+ * Os valores são tratados como 3 dígitos significativos (100..988) e uma
+ * década: valor = significativo * 10^(década - 2). A busca é feita no espaço
+ * logarítmico, ou seja, retorna o valor mais próximo em razão (erro
+ * percentual), que é o critério de tolerância das séries.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/ohms_q8.h"
+
+typedef enum {
+  E_SERIES_E24 = 24,   // 5% - 2 dígitos, código de 4 bandas
+  E_SERIES_E48 = 48,   // 2% - 3 dígitos, código de 5 bandas
+  E_SERIES_E96 = 96,   // 1%
+  E_SERIES_E192 = 192  // 0,5%
+} e_series_t;
+
+// Quantidade máxima de bandas de valor (dígitos + multiplicador)
+#define E_SERIES_MAX_BANDS 4
+
+typedef struct {
+  ohms_q8_t value;         // valor comercial
+  uint16_t significand;    // 3 dígitos significativos (100..988)
+  int8_t decade;           // expoente de 10 do valor (ex.: 4700 => 3)
+  uint8_t band_count;      // bandas de valor: 3 (E24) ou 4 (E48 em diante)
+  int8_t bands[E_SERIES_MAX_BANDS]; // dígitos e multiplicador por último (-1 = sem cor)
+} e_series_match_t;
+
+// Valor comercial mais próximo de ohms na série indicada, com década e cores
+// das bandas calculadas na mesma passagem, só com aritmética inteira. Retorna
+// false para valores fora de 0,01 Ω..10 MΩ (match é zerado, com multiplicador -1).
+bool e_series_nearest(e_series_t series, ohms_q8_t ohms, e_series_match_t *match);
+
+#endif // E_SERIES_H
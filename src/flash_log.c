@@ -0,0 +1,225 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "src/crc32.h"
+#include "src/flash_log.h"
+#include "src/history.h"
+#include "src/metrics.h"
+
+// Página em montagem. É também a origem da gravação (hal_flash_program exige
+// a origem na RAM).
+static struct {
+  flash_log_page_t header;
+  uint8_t records[FLASH_LOG_RECORDS_MAX];
+} flash_log_page;
+
+_Static_assert(sizeof(flash_log_page) == HAL_FLASH_PAGE_SIZE, "página do registro deve ocupar uma página da flash");
+
+// Último registro acrescentado (base da próxima diferença) e instante do primeiro
+static uint32_t flash_log_last_timestamp = 0;
+static ohms_q8_t flash_log_last_measured = 0;
+static uint32_t flash_log_opened_ms = 0;
+
+// Sequências [first, next) das páginas gravadas. Escritas pelo núcleo 1,
+// lidas por qualquer núcleo.
+static volatile uint32_t flash_log_first = 0;
+static volatile uint32_t flash_log_next = 0;
+
+static uint16_t flash_log_boot = 0;
+
+// Setor apagado com antecedência e ainda não usado: começa na sequência
+// flash_log_erased_seq
+static bool flash_log_erased = false;
+static uint32_t flash_log_erased_seq = 0;
+
+static inline uint32_t flash_log_zigzag(int32_t v) {
+  return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline uint32_t flash_log_offset(uint32_t seq) {
+  return FLASH_LOG_FLASH_OFFSET + (seq % FLASH_LOG_PAGES) * HAL_FLASH_PAGE_SIZE;
+}
+
+static uint32_t flash_log_page_crc(const uint8_t *page, uint8_t used) {
+  return crc32(page + sizeof(uint32_t), sizeof(flash_log_page_t) - sizeof(uint32_t) + used);
+}
+
+// Confere uma página copiada da flash. header recebe o cabeçalho.
+static bool flash_log_page_valid(const uint8_t *page, flash_log_page_t *header) {
+  memcpy(header, page, sizeof(*header));
+  return header->magic == FLASH_LOG_MAGIC &&
+         header->count != 0 &&
+         header->used <= FLASH_LOG_RECORDS_MAX &&
+         header->crc == flash_log_page_crc(page, header->used);
+}
+
+static bool flash_log_page_blank(uint32_t offset) {
+  const uint8_t *data = hal_flash_data() + offset;
+  for (uint32_t i = 0; i < HAL_FLASH_PAGE_SIZE; i++) {
+    if (data[i] != 0xFF) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void flash_log_init(void) {
+  bool found = false;
+  uint32_t first = 0;
+  uint32_t last = 0;
+  uint16_t boot = 0;
+
+  for (uint32_t slot = 0; slot < FLASH_LOG_PAGES; slot++) {
+    flash_log_page_t header;
+    const uint8_t *page = hal_flash_data() + FLASH_LOG_FLASH_OFFSET + slot * HAL_FLASH_PAGE_SIZE;
+    if (!flash_log_page_valid(page, &header) || header.seq % FLASH_LOG_PAGES != slot) {
+      continue;
+    }
+
+    if (!found || (int32_t)(header.seq - first) < 0) {
+      first = header.seq;
+    }
+    if (!found || (int32_t)(header.seq - last) > 0) {
+      last = header.seq;
+      boot = header.boot;
+    }
+    found = true;
+  }
+
+  flash_log_first = first;
+  flash_log_next = found ? last + 1 : 0;
+  flash_log_boot = found ? boot + 1 : 0;
+  flash_log_page.header.count = 0;
+
+  printf("Registro na flash: páginas %lu a %lu, execução %u\n",
+         (unsigned long)flash_log_first, (unsigned long)flash_log_next, (unsigned)flash_log_boot);
+}
+
+// Apaga o setor que começa na sequência seq
+static bool flash_log_erase_sector(uint32_t seq) {
+  // As páginas do setor, FLASH_LOG_PAGES sequências atrás, deixam de existir
+  uint32_t dropped_end = seq + FLASH_LOG_SECTOR_PAGES - FLASH_LOG_PAGES;
+  if (seq >= FLASH_LOG_PAGES - FLASH_LOG_SECTOR_PAGES && (int32_t)(dropped_end - flash_log_first) > 0) {
+    flash_log_first = dropped_end;
+  }
+  if (!hal_flash_erase(flash_log_offset(seq), HAL_FLASH_SECTOR_SIZE)) {
+    return false;
+  }
+
+  flash_log_erased = true;
+  flash_log_erased_seq = seq;
+  return true;
+}
+
+// Grava a página montada na próxima posição livre
+static bool flash_log_write(void) {
+  METRICS_SCOPE(METRICS_FLASH_LOG_WRITE);
+
+  uint32_t seq = flash_log_next;
+
+  // Uma gravação interrompida (queda de energia) deixa a posição suja: ela é
+  // pulada até o próximo setor, que será apagado
+  while (seq % FLASH_LOG_SECTOR_PAGES != 0 && !flash_log_page_blank(flash_log_offset(seq))) {
+    seq++;
+  }
+
+  if (seq % FLASH_LOG_SECTOR_PAGES == 0) {
+    // O setor normalmente já foi apagado por flash_log_service; só é apagado
+    // aqui se ainda não houve oportunidade
+    if (!(flash_log_erased && flash_log_erased_seq == seq) && !flash_log_erase_sector(seq)) {
+      return false;
+    }
+    flash_log_erased = false;
+  }
+
+  flash_log_page.header.crc = 0;
+  flash_log_page.header.magic = FLASH_LOG_MAGIC;
+  flash_log_page.header.boot = flash_log_boot;
+  flash_log_page.header.seq = seq;
+  flash_log_page.header.reserved = 0;
+  memset(flash_log_page.records + flash_log_page.header.used, 0xFF,
+         FLASH_LOG_RECORDS_MAX - flash_log_page.header.used);
+  flash_log_page.header.crc = flash_log_page_crc((const uint8_t *)&flash_log_page, flash_log_page.header.used);
+
+  uint32_t offset = flash_log_offset(seq);
+  bool ok = hal_flash_program(offset, &flash_log_page, sizeof(flash_log_page)) &&
+            memcmp(hal_flash_data() + offset, &flash_log_page, sizeof(flash_log_page)) == 0;
+
+  // A página só fica visível aos leitores depois de gravada
+  hal_memory_barrier();
+  flash_log_next = seq + 1;
+  return ok;
+}
+
+bool flash_log_flush(void) {
+  if (!flash_log_page.header.count) {
+    return true;
+  }
+
+  bool ok = flash_log_write();
+  if (!ok) {
+    printf("Falha ao gravar o registro na flash\n");
+  }
+  flash_log_page.header.count = 0;
+  return ok;
+}
+
+bool flash_log_append(const measurement_t *measurement) {
+  bool ok = true;
+
+  if (flash_log_page.header.count) {
+    uint8_t entry[HISTORY_ENTRY_MAX];
+    uint8_t len = history_put_varint(entry, measurement->timestamp_ms - flash_log_last_timestamp);
+    len += history_put_varint(entry + len, flash_log_zigzag((int32_t)(measurement->measured - flash_log_last_measured)));
+
+    if (flash_log_page.header.used + len <= FLASH_LOG_RECORDS_MAX && flash_log_page.header.count < UINT8_MAX) {
+      memcpy(flash_log_page.records + flash_log_page.header.used, entry, len);
+      flash_log_page.header.used += len;
+      flash_log_page.header.count++;
+      flash_log_last_timestamp = measurement->timestamp_ms;
+      flash_log_last_measured = measurement->measured;
+      return true;
+    }
+
+    // Página cheia: grava e começa a próxima com esta medição
+    ok = flash_log_flush();
+  }
+
+  flash_log_page.header.timestamp_ms = measurement->timestamp_ms;
+  flash_log_page.header.measured = measurement->measured;
+  flash_log_page.header.count = 1;
+  flash_log_page.header.used = 0;
+  flash_log_opened_ms = hal_time_ms();
+  flash_log_last_timestamp = measurement->timestamp_ms;
+  flash_log_last_measured = measurement->measured;
+  return ok;
+}
+
+void flash_log_service(uint32_t now_ms) {
+  if (flash_log_page.header.count && now_ms - flash_log_opened_ms >= FLASH_LOG_FLUSH_MS) {
+    flash_log_flush();
+  }
+
+  // Apaga já o setor da próxima página que começar um setor, para que
+  // flash_log_append só precise gravar páginas
+  uint32_t seq = (flash_log_next + FLASH_LOG_SECTOR_PAGES - 1) / FLASH_LOG_SECTOR_PAGES * FLASH_LOG_SECTOR_PAGES;
+  if (!(flash_log_erased && flash_log_erased_seq == seq)) {
+    flash_log_erase_sector(seq);
+  }
+}
+
+void flash_log_range(uint32_t *first, uint32_t *end) {
+  *end = flash_log_next;
+  hal_memory_barrier();
+  *first = flash_log_first;
+  if ((int32_t)(*end - *first) < 0) {
+    *first = *end;
+  }
+}
+
+bool flash_log_read_page(uint32_t seq, uint8_t page[HAL_FLASH_PAGE_SIZE]) {
+  flash_log_page_t header;
+  memcpy(page, hal_flash_data() + flash_log_offset(seq), HAL_FLASH_PAGE_SIZE);
+  return flash_log_page_valid(page, &header) && header.seq == seq;
+}
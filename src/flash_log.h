@@ -0,0 +1,90 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+/*
+ * Registro persistente das medições publicadas, na área de dados da flash
+ * (setores após o da calibração).
+ *
+ * O registro só cresce: as medições se acumulam em uma página na RAM, que é
+ * gravada inteira (HAL_FLASH_PAGE_SIZE bytes) quando enche ou quando a mais
+ * antiga espera há FLASH_LOG_FLUSH_MS. Cada página gravada recebe uma
+ * sequência crescente e ocupa a posição seq % FLASH_LOG_PAGES, então as
+ * gravações percorrem os setores em círculo e todos são apagados o mesmo
+ * número de vezes (nivelamento de desgaste). O setor em que começará a
+ * próxima página é apagado com antecedência por flash_log_service,
+ * descartando as páginas mais antigas.
+ *
+ * Formato de cada página: flash_log_page_t seguido de used bytes de
+ * registros. O primeiro registro está no cabeçalho (valores absolutos); os
+ * demais são diferenças em relação ao anterior, em varints como no
+ * histórico (src/history.h):
+ *   varint(timestamp_ms - anterior)
+ *   varint(zigzag(medido - anterior))   (ohms em Q24.8)
+ * O timestamp conta a partir da inicialização; boot distingue as execuções.
+ *
+ * Escrita: apenas o núcleo 1 (flash_log_append/flash_log_service), que já
+ * detém a flash para a calibração. As medições só vão para a RAM; a gravação
+ * de uma página pausa o núcleo 0 por cerca de 1 ms. O apagamento de um setor,
+ * a cada FLASH_LOG_SECTOR_PAGES páginas, pausa o núcleo 0 por algumas dezenas
+ * de ms e fica fora de flash_log_append, em flash_log_service.
+ * Leitura: qualquer núcleo (flash_log_read_page), conferindo CRC e sequência
+ * de cada página, pois ela pode ter sido apagada nesse meio tempo.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hal/hal.h"
+#include "src/measurement.h"
+
+// Trecho da área de dados da flash (hal_flash_*) usado pelo registro: o
+// primeiro setor é da calibração (CALIBRATION_FLASH_OFFSET)
+#define FLASH_LOG_FLASH_OFFSET HAL_FLASH_SECTOR_SIZE
+#define FLASH_LOG_FLASH_SIZE (HAL_FLASH_DATA_SIZE - FLASH_LOG_FLASH_OFFSET)
+
+#define FLASH_LOG_SECTOR_PAGES (HAL_FLASH_SECTOR_SIZE / HAL_FLASH_PAGE_SIZE)
+#define FLASH_LOG_PAGES (FLASH_LOG_FLASH_SIZE / HAL_FLASH_PAGE_SIZE)
+
+// Página parcial é gravada quando a medição mais antiga nela esperar este
+// tempo (perda máxima em uma queda de energia)
+#define FLASH_LOG_FLUSH_MS (5u * 60u * 1000u)
+
+#define FLASH_LOG_MAGIC 0x474Cu // "LG"
+
+// Cabeçalho de cada página gravada
+typedef struct {
+  uint32_t crc;           // CRC-32 do restante do cabeçalho e dos registros
+  uint16_t magic;
+  uint16_t boot;          // execução do firmware que gravou a página
+  uint32_t seq;           // sequência da página
+  uint32_t timestamp_ms;  // primeiro registro
+  ohms_q8_t measured;     // primeiro registro
+  uint8_t count;          // registros na página, incluindo o primeiro
+  uint8_t used;           // bytes de registros após o cabeçalho
+  uint16_t reserved;
+} flash_log_page_t;
+
+#define FLASH_LOG_RECORDS_MAX (HAL_FLASH_PAGE_SIZE - sizeof(flash_log_page_t))
+
+// Localiza as páginas gravadas e o número da execução atual (antes de iniciar
+// o núcleo 1)
+void flash_log_init(void);
+
+// Acrescenta uma medição (núcleo 1). Grava a página quando ela enche.
+// Retorna false se a gravação falhou (a medição é descartada).
+bool flash_log_append(const measurement_t *measurement);
+
+// Grava a página parcial após FLASH_LOG_FLUSH_MS e apaga o próximo setor
+// antes de ele ser necessário (núcleo 1, periodicamente)
+void flash_log_service(uint32_t now_ms);
+
+// Grava a página parcial imediatamente (núcleo 1)
+bool flash_log_flush(void);
+
+// Sequências [first, end) das páginas possivelmente disponíveis
+void flash_log_range(uint32_t *first, uint32_t *end);
+
+// Copia a página seq para page se ela ainda estiver gravada e íntegra
+bool flash_log_read_page(uint32_t seq, uint8_t page[HAL_FLASH_PAGE_SIZE]);
+
+#endif // FLASH_LOG_H
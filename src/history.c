@@ -0,0 +1,142 @@
+#include "hal/hal.h"
+#include "src/history.h"
+
+#define HISTORY_MASK (HISTORY_SIZE - 1)
+#define HISTORY_QUEUE_MASK (HISTORY_QUEUE_SIZE - 1)
+
+static uint8_t history_ring[HISTORY_SIZE];
+
+// Posições absolutas (crescentes) da entrada mais antiga e do fim do buffer
+static uint32_t history_tail = 0;
+static uint32_t history_head = 0;
+
+// Valores da última entrada descartada (base da mais antiga) e da última gravada
+static history_base_t history_tail_base = {0};
+static history_base_t history_head_base = {0};
+
+// Fila entre os núcleos: o núcleo 1 só escreve queue_head, o núcleo 0 só queue_tail
+typedef struct {
+  uint32_t timestamp_ms;
+  ohms_q8_t measured;
+} history_sample_t;
+
+static history_sample_t history_queue[HISTORY_QUEUE_SIZE];
+static volatile uint32_t history_queue_head = 0;
+static volatile uint32_t history_queue_tail = 0;
+
+static inline uint32_t history_zigzag(int32_t v) {
+  return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t history_unzigzag(uint32_t v) {
+  return (int32_t)(v >> 1) ^ -(int32_t)(v & 1u);
+}
+
+uint8_t history_put_varint(uint8_t *out, uint32_t v) {
+  uint8_t len = 0;
+  while (v >= 0x80u) {
+    out[len++] = (uint8_t)(v | 0x80u);
+    v >>= 7;
+  }
+  out[len++] = (uint8_t)v;
+  return len;
+}
+
+// Lê um varint do buffer circular na posição absoluta pos. Retorna o tamanho.
+static uint8_t history_get_varint(uint32_t pos, uint32_t *v) {
+  uint32_t value = 0;
+  uint8_t len = 0;
+  uint8_t byte;
+
+  do {
+    byte = history_ring[(pos + len) & HISTORY_MASK];
+    value |= (uint32_t)(byte & 0x7Fu) << (7 * len);
+    len++;
+  } while ((byte & 0x80u) && len < 5);
+
+  *v = value;
+  return len;
+}
+
+// Decodifica a entrada em pos sobre base. Retorna o tamanho da entrada.
+static uint32_t history_decode(uint32_t pos, history_base_t *base) {
+  uint32_t dt;
+  uint32_t dm;
+  uint32_t len = history_get_varint(pos, &dt);
+  len += history_get_varint(pos + len, &dm);
+
+  base->seq++;
+  base->timestamp_ms += dt;
+  base->measured += (uint32_t)history_unzigzag(dm);
+  return len;
+}
+
+bool history_push(const measurement_t *measurement) {
+  uint32_t head = history_queue_head;
+  if (head - history_queue_tail >= HISTORY_QUEUE_SIZE) {
+    return false;
+  }
+
+  history_queue[head & HISTORY_QUEUE_MASK].timestamp_ms = measurement->timestamp_ms;
+  history_queue[head & HISTORY_QUEUE_MASK].measured = measurement->measured;
+
+  // A entrada precisa estar completa antes de o consumidor ver o novo índice
+  hal_memory_barrier();
+  history_queue_head = head + 1;
+  return true;
+}
+
+static void history_append(const history_sample_t *sample) {
+  uint8_t entry[HISTORY_ENTRY_MAX];
+  uint8_t len = history_put_varint(entry, sample->timestamp_ms - history_head_base.timestamp_ms);
+  len += history_put_varint(entry + len, history_zigzag((int32_t)(sample->measured - history_head_base.measured)));
+
+  // Abre espaço descartando as entradas mais antigas
+  while (history_head + len - history_tail > HISTORY_SIZE) {
+    history_tail += history_decode(history_tail, &history_tail_base);
+  }
+
+  for (uint8_t i = 0; i < len; i++) {
+    history_ring[(history_head + i) & HISTORY_MASK] = entry[i];
+  }
+  history_head += len;
+
+  history_head_base.seq++;
+  history_head_base.timestamp_ms = sample->timestamp_ms;
+  history_head_base.measured = sample->measured;
+}
+
+uint32_t history_drain(void) {
+  uint32_t tail = history_queue_tail;
+  uint32_t head = history_queue_head;
+  hal_memory_barrier();
+
+  for (; tail != head; tail++) {
+    history_append(&history_queue[tail & HISTORY_QUEUE_MASK]);
+  }
+
+  hal_memory_barrier();
+  history_queue_tail = tail;
+  return history_tail;
+}
+
+void history_find(uint32_t since, history_range_t *range) {
+  history_base_t base = history_tail_base;
+  uint32_t pos = history_tail;
+
+  while (pos != history_head && base.seq < since) {
+    pos += history_decode(pos, &base);
+  }
+
+  range->base = base;
+  range->start = pos;
+  range->end = history_head;
+  range->count = history_head_base.seq - base.seq;
+}
+
+const uint8_t *history_data(uint32_t pos, uint32_t end, uint32_t *contiguous) {
+  uint32_t offset = pos & HISTORY_MASK;
+  uint32_t len = end - pos;
+  *contiguous = len < HISTORY_SIZE - offset ? len : HISTORY_SIZE - offset;
+  return &history_ring[offset];
+}
@@ -0,0 +1,70 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+/*
+ * Histórico das medições publicadas.
+ *
+ * As entradas ficam em um buffer circular de HISTORY_SIZE bytes, codificadas
+ * como diferenças em relação à entrada anterior, em varints (7 bits por
+ * byte, o bit 7 indica continuação):
+ *   varint(timestamp_ms - anterior)
+ *   varint(zigzag(medido - anterior))   (ohms em Q24.8)
+ * Uma leitura estável custa de 2 a 4 bytes, então alguns KB guardam milhares
+ * de entradas. Quando o buffer enche, as entradas mais antigas são
+ * descartadas e os valores absolutos da última descartada viram a base das
+ * diferenças seguintes.
+ *
+ * Cada entrada recebe um número de sequência (1, 2, ...). /api/history?since=N
+ * envia a base (valores da entrada anterior à primeira enviada) seguida dos
+ * bytes do buffer, sem cópia.
+ *
+ * Produtor: o núcleo 1 enfileira as medições (history_push, fila SPSC sem
+ * travas). Consumidor: o núcleo 0 codifica a fila no buffer (history_drain)
+ * e lê o buffer, sempre no contexto do lwIP (dentro de hal_net_lock).
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/measurement.h"
+
+#define HISTORY_SIZE 8192u      // potência de 2
+#define HISTORY_QUEUE_SIZE 16u  // potência de 2
+#define HISTORY_ENTRY_MAX 10u   // maior entrada codificada (dois varints de 32 bits)
+
+// Valores absolutos de uma entrada, base para decodificar as seguintes
+typedef struct {
+  uint32_t seq;
+  uint32_t timestamp_ms;
+  ohms_q8_t measured;
+} history_base_t;
+
+// Trecho do buffer a partir de uma sequência: bytes [start, end) (posições
+// absolutas, crescentes) com count entradas decodificadas a partir de base
+typedef struct {
+  history_base_t base;
+  uint32_t start;
+  uint32_t end;
+  uint32_t count;
+} history_range_t;
+
+// Enfileira uma medição publicada (núcleo 1). Retorna false se a fila estiver cheia.
+bool history_push(const measurement_t *measurement);
+
+// Codifica no buffer as medições enfileiradas (núcleo 0). Retorna a nova
+// posição da entrada mais antiga: bytes anteriores a ela foram sobrescritos.
+uint32_t history_drain(void);
+
+// Localiza as entradas com sequência maior que since. Se since for anterior à
+// entrada mais antiga, o trecho começa nela (o cliente percebe a lacuna pela
+// sequência da base).
+void history_find(uint32_t since, history_range_t *range);
+
+// Ponteiro para o byte na posição absoluta pos e quantos bytes seguem
+// contíguos até o fim do trecho ou a volta do buffer
+const uint8_t *history_data(uint32_t pos, uint32_t end, uint32_t *contiguous);
+
+// Codifica v como varint em out (até 5 bytes). Retorna o tamanho.
+uint8_t history_put_varint(uint8_t *out, uint32_t v);
+
+#endif // HISTORY_H
@@ -0,0 +1,35 @@
+#include "hal/hal.h"
+#include "src/measurement.h"
+
+static volatile uint32_t measurement_seq = 0;
+static measurement_t measurement_latest;
+
+void measurement_publish(const measurement_t *measurement) {
+  measurement_seq++; // ímpar: escrita em andamento
+  hal_memory_barrier();
+
+  measurement_latest = *measurement;
+
+  hal_memory_barrier();
+  measurement_seq++; // par: medição consistente
+}
+
+uint32_t measurement_read(measurement_t *measurement) {
+  uint32_t begin, end;
+
+  do {
+    begin = measurement_seq;
+    hal_memory_barrier();
+
+    *measurement = measurement_latest;
+
+    hal_memory_barrier();
+    end = measurement_seq;
+  } while ((begin & 1u) || begin != end);
+
+  return begin / 2;
+}
+
+uint32_t measurement_sequence(void) {
+  return (measurement_seq & ~1u) / 2;
+}
@@ -0,0 +1,40 @@
+#ifndef MEASUREMENT_H
+#define MEASUREMENT_H
+
+/*
+ * Última medição publicada.
+ *
+ * O núcleo 1 mede e publica; o núcleo 0 (servidor HTTP / callbacks do lwIP)
+ * lê. A troca é feita por um seqlock: o escritor torna a sequência ímpar
+ * durante a cópia e par ao terminar; o leitor repete a leitura se a sequência
+ * for ímpar ou tiver mudado durante a cópia. Assim nenhum dos lados bloqueia
+ * e o leitor nunca vê uma medição pela metade.
+ *
+ * Existe um único escritor (measurement_publish).
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/ohms_q8.h"
+
+typedef struct {
+  ohms_q8_t measured;     // resistência medida
+  ohms_q8_t e24;          // valor comercial mais próximo da série E24
+  int8_t bands[3];        // índices das cores: 1ª banda, 2ª banda e multiplicador (-1 = fora da faixa)
+  uint8_t range;          // faixa de medição (índice em resistor_ranges)
+  uint32_t samples;       // amostras do ADC usadas na medição
+  uint32_t timestamp_ms;  // instante da medição (ms desde o boot)
+} measurement_t;
+
+// Publica uma nova medição (apenas o núcleo de aquisição)
+void measurement_publish(const measurement_t *measurement);
+
+// Copia a última medição publicada. Retorna o número de sequência dela
+// (0 enquanto nada foi publicado), útil para detectar medições novas.
+uint32_t measurement_read(measurement_t *measurement);
+
+// Número de sequência da última medição publicada, sem copiá-la
+uint32_t measurement_sequence(void);
+
+#endif // MEASUREMENT_H
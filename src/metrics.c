@@ -0,0 +1,178 @@
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "src/adc_stream.h"
+#include "src/metrics.h"
+#include "src/scheduler.h"
+
+#if METRICS_ENABLED
+
+#include "lwip/stats.h"
+
+metrics_timer_t metrics_timers[METRICS_TIMER_COUNT];
+
+// Rótulo scope de cada temporizador (nome da função medida)
+static const char *const metrics_timer_names[METRICS_TIMER_COUNT] = {
+  [METRICS_RESISTOR_MEASURE]   = "resistor_measure",
+  [METRICS_DISPLAY_DRAW]       = "draw_display_measurement",
+  [METRICS_SSD1306_SEND]       = "ssd1306_send_data",
+  [METRICS_SSD1306_SEND_ASYNC] = "ssd1306_send_data_async",
+  [METRICS_FLASH_LOG_WRITE]    = "flash_log_write",
+  [METRICS_TCP_RECV]           = "tcp_server_recv",
+};
+
+typedef struct {
+  char *buffer;
+  size_t size;
+  size_t len;
+  bool overflow;
+} metrics_writer_t;
+
+static void metrics_printf(metrics_writer_t *writer, const char *format, ...) {
+  if (writer->overflow) {
+    return;
+  }
+
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(writer->buffer + writer->len, writer->size - writer->len, format, args);
+  va_end(args);
+
+  if (len < 0 || (size_t)len >= writer->size - writer->len) {
+    writer->overflow = true;
+    return;
+  }
+  writer->len += (size_t)len;
+}
+
+static void metrics_render_timers(metrics_writer_t *w) {
+  metrics_printf(w, "# HELP meter_duration_us Duração dos trechos instrumentados\n"
+                    "# TYPE meter_duration_us histogram\n");
+  for (int i = 0; i < METRICS_TIMER_COUNT; i++) {
+    const metrics_timer_t *timer = &metrics_timers[i];
+    uint32_t cumulative = 0;
+    uint32_t le = 1;
+
+    for (int b = 0; b < METRICS_BUCKETS - 1; b++, le *= 4) {
+      cumulative += timer->buckets[b];
+      metrics_printf(w, "meter_duration_us_bucket{scope=\"%s\",le=\"%lu\"} %lu\n",
+                     metrics_timer_names[i], (unsigned long)le, (unsigned long)cumulative);
+    }
+    metrics_printf(w, "meter_duration_us_bucket{scope=\"%s\",le=\"+Inf\"} %lu\n"
+                      "meter_duration_us_sum{scope=\"%s\"} %llu\n"
+                      "meter_duration_us_count{scope=\"%s\"} %lu\n",
+                   metrics_timer_names[i], (unsigned long)timer->count,
+                   metrics_timer_names[i], (unsigned long long)timer->sum_us,
+                   metrics_timer_names[i], (unsigned long)timer->count);
+  }
+
+  static const char *const gauges[] = {"min", "max", "mean"};
+  for (int g = 0; g < 3; g++) {
+    metrics_printf(w, "# TYPE meter_duration_%s_us gauge\n", gauges[g]);
+    for (int i = 0; i < METRICS_TIMER_COUNT; i++) {
+      const metrics_timer_t *timer = &metrics_timers[i];
+      uint32_t value = g == 0 ? timer->min_us
+                     : g == 1 ? timer->max_us
+                     : timer->count ? (uint32_t)(timer->sum_us / timer->count) : 0;
+      metrics_printf(w, "meter_duration_%s_us{scope=\"%s\"} %lu\n",
+                     gauges[g], metrics_timer_names[i], (unsigned long)value);
+    }
+  }
+}
+
+// Tempo ocioso (em hal_event_wait), despertares e execuções de cada tarefa
+static void metrics_render_scheduler(metrics_writer_t *w) {
+  metrics_printf(w, "# TYPE meter_scheduler_idle_ms_total counter\n");
+  for (uint8_t i = 0; i < scheduler_count(); i++) {
+    const scheduler_t *s = scheduler_get(i);
+    metrics_printf(w, "meter_scheduler_idle_ms_total{scheduler=\"%s\"} %lu\n",
+                   s->name, (unsigned long)s->idle_ms);
+  }
+
+  metrics_printf(w, "# TYPE meter_scheduler_wakeups_total counter\n");
+  for (uint8_t i = 0; i < scheduler_count(); i++) {
+    const scheduler_t *s = scheduler_get(i);
+    metrics_printf(w, "meter_scheduler_wakeups_total{scheduler=\"%s\"} %lu\n",
+                   s->name, (unsigned long)s->wakeups);
+  }
+
+  metrics_printf(w, "# TYPE meter_scheduler_task_runs_total counter\n");
+  for (uint8_t i = 0; i < scheduler_count(); i++) {
+    const scheduler_t *s = scheduler_get(i);
+    for (uint8_t t = 0; t < s->count; t++) {
+      metrics_printf(w, "meter_scheduler_task_runs_total{scheduler=\"%s\",task=\"%s\"} %lu\n",
+                     s->name, s->tasks[t].name, (unsigned long)s->tasks[t].runs);
+    }
+  }
+}
+
+#if LWIP_STATS
+static void metrics_render_lwip(metrics_writer_t *w) {
+  // Heap (MEM_SIZE, em bytes) e pools de tamanho fixo (em elementos)
+  const struct stats_mem *pools[] = {
+    &lwip_stats.mem,
+    lwip_stats.memp[MEMP_TCP_PCB],
+    lwip_stats.memp[MEMP_TCP_SEG],
+    lwip_stats.memp[MEMP_PBUF],
+    lwip_stats.memp[MEMP_PBUF_POOL],
+  };
+  static const char *const pool_names[] = {"HEAP", "TCP_PCB", "TCP_SEG", "PBUF", "PBUF_POOL"};
+  static const char *const fields[] = {"used", "max", "avail"};
+
+  for (int f = 0; f < 3; f++) {
+    metrics_printf(w, "# TYPE lwip_pool_%s gauge\n", fields[f]);
+    for (unsigned p = 0; p < sizeof(pools) / sizeof(pools[0]); p++) {
+      unsigned long value = f == 0 ? (unsigned long)pools[p]->used
+                          : f == 1 ? (unsigned long)pools[p]->max
+                          : (unsigned long)pools[p]->avail;
+      metrics_printf(w, "lwip_pool_%s{pool=\"%s\"} %lu\n", fields[f], pool_names[p], value);
+    }
+  }
+
+  metrics_printf(w, "# TYPE lwip_pool_errors_total counter\n");
+  for (unsigned p = 0; p < sizeof(pools) / sizeof(pools[0]); p++) {
+    metrics_printf(w, "lwip_pool_errors_total{pool=\"%s\"} %lu\n", pool_names[p], (unsigned long)pools[p]->err);
+  }
+
+  metrics_printf(w, "# TYPE lwip_tcp_segments_total counter\n"
+                    "lwip_tcp_segments_total{dir=\"xmit\"} %lu\n"
+                    "lwip_tcp_segments_total{dir=\"recv\"} %lu\n"
+                    "# TYPE lwip_tcp_errors_total counter\n"
+                    "lwip_tcp_errors_total{type=\"drop\"} %lu\n"
+                    "lwip_tcp_errors_total{type=\"memerr\"} %lu\n"
+                    "lwip_tcp_errors_total{type=\"err\"} %lu\n",
+                 (unsigned long)lwip_stats.tcp.xmit, (unsigned long)lwip_stats.tcp.recv,
+                 (unsigned long)lwip_stats.tcp.drop, (unsigned long)lwip_stats.tcp.memerr,
+                 (unsigned long)lwip_stats.tcp.err);
+
+#if UDP_STATS
+  // Datagramas da telemetria (src/telemetry.h)
+  metrics_printf(w, "# TYPE lwip_udp_datagrams_total counter\n"
+                    "lwip_udp_datagrams_total{dir=\"xmit\"} %lu\n"
+                    "# TYPE lwip_udp_errors_total counter\n"
+                    "lwip_udp_errors_total{type=\"memerr\"} %lu\n"
+                    "lwip_udp_errors_total{type=\"err\"} %lu\n",
+                 (unsigned long)lwip_stats.udp.xmit, (unsigned long)lwip_stats.udp.memerr,
+                 (unsigned long)lwip_stats.udp.err);
+#endif
+}
+#endif
+
+int metrics_render(char *buffer, size_t size) {
+  metrics_writer_t writer = { buffer, size, 0, false };
+
+  metrics_printf(&writer, "# TYPE meter_uptime_seconds gauge\nmeter_uptime_seconds %lu\n",
+                 (unsigned long)(hal_time_ms() / 1000u));
+  metrics_printf(&writer, "# TYPE meter_adc_overruns_total counter\nmeter_adc_overruns_total %lu\n",
+                 (unsigned long)adc_stream_overruns());
+  metrics_render_timers(&writer);
+  metrics_render_scheduler(&writer);
+#if LWIP_STATS
+  metrics_render_lwip(&writer);
+#endif
+
+  return writer.overflow ? -1 : (int)writer.len;
+}
+
+#endif // METRICS_ENABLED
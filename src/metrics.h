@@ -0,0 +1,102 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+/*
+ * Métricas de execução: temporizadores dos trechos críticos e estatísticas do
+ * lwIP, publicados em /metrics no formato texto do Prometheus.
+ *
+ * Cada trecho instrumentado abre um escopo com METRICS_SCOPE(id) no início do
+ * bloco; ao sair dele (por qualquer return) a duração é acumulada na tabela
+ * metrics_timers: contagem, soma, mínimo, máximo e um histograma em potências
+ * de 4 us. O custo é uma leitura do timer na entrada e outra na saída, mais
+ * algumas somas.
+ *
+ * Com METRICS_ENABLED=0 (opção METRICS do CMake) os escopos não geram código,
+ * a tabela não existe e /metrics responde 404. O mesmo vale para as
+ * estatísticas do lwIP (LWIP_STATS em lwipopts.h).
+ *
+ * Cada temporizador é escrito por um único núcleo (o que executa o trecho).
+ * A leitura pelo núcleo 0 não é atômica: um valor pode vir de uma execução
+ * à frente de outro, o que é irrelevante para métricas.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hal/hal.h"
+
+#ifndef METRICS_ENABLED
+#define METRICS_ENABLED 0
+#endif
+
+// Trechos instrumentados
+typedef enum {
+  METRICS_RESISTOR_MEASURE = 0,   // resistor_measure (núcleo 1)
+  METRICS_DISPLAY_DRAW,           // draw_display_measurement (núcleo 1)
+  METRICS_SSD1306_SEND,           // ssd1306_send_data, bloqueante
+  METRICS_SSD1306_SEND_ASYNC,     // ssd1306_send_data_async (montagem da transferência)
+  METRICS_FLASH_LOG_WRITE,        // gravação de uma página do registro (núcleo 1)
+  METRICS_TCP_RECV,               // tcp_server_recv (núcleo 0)
+  METRICS_TIMER_COUNT
+} metrics_timer_id_t;
+
+// Faixas do histograma: até 1, 4, 16, ... 4^(METRICS_BUCKETS - 2) us e acima
+#define METRICS_BUCKETS 10
+
+typedef struct {
+  uint32_t count;
+  uint32_t min_us;
+  uint32_t max_us;
+  uint64_t sum_us;
+  uint32_t buckets[METRICS_BUCKETS];
+} metrics_timer_t;
+
+#if METRICS_ENABLED
+
+extern metrics_timer_t metrics_timers[METRICS_TIMER_COUNT];
+
+static inline void metrics_record(metrics_timer_id_t id, uint32_t us) {
+  metrics_timer_t *timer = &metrics_timers[id];
+
+  // Faixa i: us <= 4^i
+  uint32_t bucket = us > 1 ? (uint32_t)(33 - __builtin_clz(us - 1)) / 2 : 0;
+  if (bucket > METRICS_BUCKETS - 1) {
+    bucket = METRICS_BUCKETS - 1;
+  }
+
+  if (!timer->count || us < timer->min_us) {
+    timer->min_us = us;
+  }
+  if (us > timer->max_us) {
+    timer->max_us = us;
+  }
+  timer->sum_us += us;
+  timer->buckets[bucket]++;
+  timer->count++;
+}
+
+typedef struct {
+  uint32_t start_us;
+  metrics_timer_id_t id;
+} metrics_scope_t;
+
+static inline void metrics_scope_end(metrics_scope_t *scope) {
+  metrics_record(scope->id, hal_timer_us32() - scope->start_us);
+}
+
+// Mede do ponto da declaração até o fim do bloco (um escopo por bloco)
+#define METRICS_SCOPE(id) \
+  __attribute__((cleanup(metrics_scope_end))) metrics_scope_t metrics_scope = { hal_timer_us32(), (id) }
+
+// Escreve as métricas em texto do Prometheus. Deve ser chamada no contexto do
+// lwIP (callbacks ou dentro de hal_net_lock). Retorna o tamanho escrito ou
+// -1 se não couber.
+int metrics_render(char *buffer, size_t size);
+
+#else
+
+#define METRICS_SCOPE(id) ((void)0)
+
+#endif // METRICS_ENABLED
+
+#endif // METRICS_H
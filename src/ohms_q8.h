@@ -0,0 +1,36 @@
+#ifndef OHMS_Q8_H
+#define OHMS_Q8_H
+
+/*
+ * Resistência em ponto fixo Q24.8 (ohms * 256).
+ *
+ * O RP2040 não tem FPU: toda a cadeia de medição (média, equação do divisor
+ * e busca na série E) usa este formato, e a conversão para texto é feita com
+ * aritmética inteira. Faixa: 0 a ~16,7 MΩ com resolução de 1/256 Ω.
+ */
+
+#include <stdint.h>
+
+typedef uint32_t ohms_q8_t;
+
+#define OHMS_Q8_FRAC_BITS 8
+#define OHMS_Q8_ONE (1u << OHMS_Q8_FRAC_BITS)
+
+// Valor saturado (circuito aberto ou fora da faixa)
+#define OHMS_Q8_MAX UINT32_MAX
+
+static inline ohms_q8_t ohms_q8_from_int(uint32_t ohms) {
+  return ohms << OHMS_Q8_FRAC_BITS;
+}
+
+// Ohms inteiros, arredondados
+static inline uint32_t ohms_q8_round(ohms_q8_t value) {
+  return (uint32_t)(((uint64_t)value + OHMS_Q8_ONE / 2) >> OHMS_Q8_FRAC_BITS);
+}
+
+// Décimos de ohm, arredondados (para exibir com uma casa decimal)
+static inline uint32_t ohms_q8_tenths(ohms_q8_t value) {
+  return (uint32_t)(((uint64_t)value * 10u + OHMS_Q8_ONE / 2) >> OHMS_Q8_FRAC_BITS);
+}
+
+#endif // OHMS_Q8_H
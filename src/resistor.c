@@ -0,0 +1,166 @@
+#include "hal/hal.h"
+#include "src/adc_filter.h"
+#include "src/adc_stream.h"
+#include "src/calibration.h"
+#include "src/metrics.h"
+#include "src/resistor.h"
+
+// Tabela de calibração das faixas: valores nominais dos resistores de
+// referência (1%). Para mais exatidão, substituir pela resistência medida
+// entre o GPIO em nível alto e o nó do divisor, e pelo offset medido com as
+// pontas em curto.
+const resistor_range_t resistor_ranges[RESISTOR_RANGE_COUNT] = {
+  { .gpio = 16, .reference = 330u << OHMS_Q8_FRAC_BITS,    .offset = 0 }, // 10 Ω - 1,3 kΩ
+  { .gpio = 17, .reference = 3300u << OHMS_Q8_FRAC_BITS,   .offset = 0 }, // 820 Ω - 13 kΩ
+  { .gpio = 18, .reference = 33000u << OHMS_Q8_FRAC_BITS,  .offset = 0 }, // 8,2 kΩ - 130 kΩ
+  { .gpio = 19, .reference = 330000u << OHMS_Q8_FRAC_BITS, .offset = 0 }, // 82 kΩ - 1 MΩ
+};
+
+static uint8_t active_range = RESISTOR_RANGE_COUNT - 1;
+
+// Filtro entre a aquisição contínua e o cálculo da resistência
+static adc_filter_t resistor_filter;
+static const adc_filter_config_t resistor_filter_config = {
+  .mode = RESISTOR_FILTER_MODE,
+  .window = RESISTOR_FILTER_WINDOW,
+  .trim = RESISTOR_FILTER_TRIM,
+  .ewma_shift = RESISTOR_FILTER_EWMA_SHIFT,
+  .outlier_lsb = RESISTOR_FILTER_OUTLIER_LSB,
+  .outlier_limit = RESISTOR_FILTER_OUTLIER_LIMIT,
+  .stable_lsb = RESISTOR_FILTER_STABLE_LSB,
+};
+
+const char *available_digit_colors[10] = {"preto", "marrom", "vermelho", "laranja", "amarelo", "verde", "azul", "violeta", "cinza", "branco"};
+
+bool resistor_setup(void) {
+  adc_filter_init(&resistor_filter, &resistor_filter_config);
+  resistor_select_range(RESISTOR_RANGE_COUNT - 1);
+  return adc_stream_start(RESISTOR_ADC_INPUT, RESISTOR_SAMPLE_RATE_HZ);
+}
+
+void resistor_select_range(uint8_t range) {
+  // Primeiro solta o pino da faixa anterior para nunca haver duas referências
+  // em paralelo
+  for (uint8_t i = 0; i < RESISTOR_RANGE_COUNT; i++) {
+    if (i != range) {
+      hal_gpio_init_input(resistor_ranges[i].gpio);
+    }
+  }
+  hal_gpio_init_output(resistor_ranges[range].gpio);
+  hal_gpio_put(resistor_ranges[range].gpio, true);
+
+  active_range = range;
+  adc_filter_reset(&resistor_filter);
+}
+
+uint8_t resistor_range(void) {
+  return active_range;
+}
+
+// Escolhe a faixa cuja referência está mais próxima (em razão) da resistência
+// estimada pelo bloco. Retorna true se a faixa mudou.
+static bool resistor_autorange(uint32_t block_sum) {
+  if (block_sum <= RESISTOR_RANGE_HIGH_LSB * ADC_FILTER_BLOCK_SAMPLES &&
+      block_sum >= RESISTOR_RANGE_LOW_LSB * ADC_FILTER_BLOCK_SAMPLES) {
+    return false;
+  }
+
+  ohms_q8_t estimate = resistor_from_adc_sum(&resistor_ranges[active_range], block_sum, ADC_FILTER_BLOCK_SAMPLES);
+  uint8_t best = 0;
+  if (estimate > 0) {
+    uint64_t best_ratio = UINT64_MAX;
+    for (uint8_t i = 0; i < RESISTOR_RANGE_COUNT; i++) {
+      uint64_t reference = resistor_ranges[i].reference;
+      uint64_t ratio = estimate > reference ? ((uint64_t)estimate << 8) / reference
+                                            : (reference << 8) / estimate;
+      if (ratio < best_ratio) {
+        best_ratio = ratio;
+        best = i;
+      }
+    }
+  }
+
+  if (best == active_range) {
+    return false; // já é a melhor faixa (ex.: circuito aberto na maior referência)
+  }
+
+  resistor_select_range(best);
+  return true;
+}
+
+ohms_q8_t resistor_measure(uint32_t *sample_count, bool *stable) {
+  METRICS_SCOPE(METRICS_RESISTOR_MEASURE);
+
+  // Sem captura (falha em resistor_setup) as amostras nunca chegariam: a
+  // leitura é inválida em vez de esperar para sempre
+  if (!adc_stream_active()) {
+    *sample_count = 0;
+    *stable = false;
+    return 0;
+  }
+
+  // As amostras são capturadas pelo DMA em segundo plano; aqui apenas se
+  // passa pelo filtro o que chegou desde a última medição
+  uint16_t chunk[64];
+  uint32_t consumed = 0;
+  uint32_t block_sum = 0;
+  uint32_t block_count = 0;
+
+  while (true) {
+    uint32_t count = adc_stream_read(chunk, sizeof(chunk) / sizeof(chunk[0]));
+    for (uint32_t i = 0; i < count; i++) {
+      // Correção de offset, ganho e DNL do ADC: uma consulta por amostra
+      uint16_t sample = calibration_apply(chunk[i]);
+      adc_filter_push(&resistor_filter, sample);
+
+      // Blocos próprios para a troca de faixa: reagem já no primeiro bloco
+      // fora da região útil, sem esperar a janela do filtro
+      block_sum += sample;
+      if (++block_count == ADC_FILTER_BLOCK_SAMPLES) {
+        if (resistor_autorange(block_sum)) {
+          // Amostras restantes ainda são da faixa anterior: descarta-as
+          // junto com as do tempo de acomodação do divisor
+          hal_sleep_us(RESISTOR_RANGE_SETTLE_US);
+          adc_stream_discard();
+          consumed = 0;
+          count = 0;
+        }
+        block_sum = 0;
+        block_count = 0;
+      }
+    }
+    consumed += count;
+
+    // Só espera quando a medição anterior foi muito recente (ex.: primeira leitura)
+    if (count == 0) {
+      if (consumed >= RESISTOR_SAMPLES && adc_filter_blocks(&resistor_filter)) {
+        break;
+      }
+      hal_sleep_us(1000000u * ADC_FILTER_BLOCK_SAMPLES / RESISTOR_SAMPLE_RATE_HZ);
+    }
+  }
+
+  *sample_count = (uint32_t)adc_filter_blocks(&resistor_filter) * ADC_FILTER_BLOCK_SAMPLES;
+  *stable = adc_filter_stable(&resistor_filter);
+  return resistor_from_adc_sum(&resistor_ranges[active_range], adc_filter_output(&resistor_filter), ADC_FILTER_BLOCK_SAMPLES);
+}
+
+ohms_q8_t resistor_from_adc_sum(const resistor_range_t *range, uint32_t adc_sum, uint32_t samples) {
+  // Divisor de tensão: R = Rref * média / (máximo - média). Multiplicando
+  // numerador e denominador pela quantidade de amostras, a média não precisa
+  // ser calculada: R = Rref * soma / (máximo * n - soma)
+  uint32_t denominator = HAL_ADC_MAX_VALUE * samples - adc_sum;
+  if (denominator == 0) {
+    return OHMS_Q8_MAX; // circuito aberto
+  }
+
+  uint64_t ohms = ((uint64_t)range->reference * adc_sum + denominator / 2) / denominator;
+  if (ohms > OHMS_Q8_MAX) {
+    return OHMS_Q8_MAX;
+  }
+  return ohms > range->offset ? (ohms_q8_t)ohms - range->offset : 0;
+}
+
+const char *resistor_band_color_name(int8_t index) {
+  return (index >= 0 && index <= 9) ? available_digit_colors[index] : "erro";
+}
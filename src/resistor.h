@@ -0,0 +1,83 @@
+#ifndef RESISTOR_H
+#define RESISTOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/adc_filter.h"
+#include "src/ohms_q8.h"
+
+// Canal do ADC ligado ao nó do divisor de tensão (GPIO 28 => ADC2)
+#define RESISTOR_ADC_INPUT 2
+
+// Taxa de amostragem da aquisição contínua do ADC
+#define RESISTOR_SAMPLE_RATE_HZ 10000
+
+// Quantidade mínima de amostras novas do ADC em cada medição. Todas as amostras
+// acumuladas desde a medição anterior passam pelo filtro (src/adc_filter.h).
+#define RESISTOR_SAMPLES 100
+
+// Configuração do filtro: janela de 16 blocos de 32 amostras (~51 ms a 10 kHz),
+// média aparada descartando 4 blocos em cada extremo, EWMA de peso 1/4,
+// rejeição de blocos a mais de 20 LSB da mediana (3 seguidos reiniciam a
+// janela) e estável com desvio padrão de até 2 LSB
+#define RESISTOR_FILTER_MODE ADC_FILTER_TRIMMED_MEAN
+#define RESISTOR_FILTER_WINDOW 16
+#define RESISTOR_FILTER_TRIM 4
+#define RESISTOR_FILTER_EWMA_SHIFT 2
+#define RESISTOR_FILTER_OUTLIER_LSB 20
+#define RESISTOR_FILTER_OUTLIER_LIMIT 3
+#define RESISTOR_FILTER_STABLE_LSB 2
+
+// Faixas de medição. Cada resistor de referência liga um GPIO ao nó do
+// divisor: o pino da faixa ativa fica em nível alto (alimenta o divisor) e os
+// das demais em alta impedância. A tensão no nó fica no meio da escala quando
+// Rx = Rref, então cada faixa cobre bem cerca de uma década em torno do seu
+// resistor. As constantes de calibração de todas as faixas ficam na tabela
+// resistor_ranges (ordem crescente de referência).
+typedef struct {
+  uint8_t gpio;          // pino que alimenta o resistor de referência
+  ohms_q8_t reference;   // resistência efetiva: resistor + saída do GPIO (calibrada)
+  ohms_q8_t offset;      // resistência em série com Rx (fios e pontas), descontada
+} resistor_range_t;
+
+#define RESISTOR_RANGE_COUNT 4
+
+extern const resistor_range_t resistor_ranges[RESISTOR_RANGE_COUNT];
+
+// Troca automática de faixa: um bloco com média acima de HIGH (Rx > ~4 Rref)
+// ou abaixo de LOW (Rx < ~Rref / 4) escolhe a faixa cuja referência é a mais
+// próxima da estimativa de Rx. Depois da troca, as amostras dos primeiros
+// RESISTOR_RANGE_SETTLE_US são descartadas.
+#define RESISTOR_RANGE_HIGH_LSB 3276
+#define RESISTOR_RANGE_LOW_LSB 819
+#define RESISTOR_RANGE_SETTLE_US 500
+
+extern const char *available_digit_colors[10];
+
+// Inicia a aquisição contínua do ADC usada por resistor_measure(), na faixa de
+// maior referência (circuito aberto não exige corrente alta do GPIO)
+bool resistor_setup(void);
+
+// Ativa a faixa indicada (índice em resistor_ranges) e descarta o filtro
+void resistor_select_range(uint8_t range);
+
+// Faixa usada pela última medição
+uint8_t resistor_range(void);
+
+// Leitura da resistência desconhecida a partir da saída do filtro, calculada
+// em ponto fixo e trocando de faixa quando necessário. Informa em *sample_count quantas amostras a janela do filtro
+// representa e em *stable se a leitura já assentou. Retorna OHMS_Q8_MAX com o
+// circuito aberto e 0, com *sample_count = 0 e *stable = false, sem a
+// aquisição ativa.
+ohms_q8_t resistor_measure(uint32_t *sample_count, bool *stable);
+
+// Equação do divisor a partir da soma de samples leituras do ADC (inteira, sem
+// média) com as constantes da faixa informada
+ohms_q8_t resistor_from_adc_sum(const resistor_range_t *range, uint32_t adc_sum, uint32_t samples);
+
+// Nome da cor correspondente ao índice de banda ("erro" se fora da faixa).
+// O valor comercial e os índices das bandas vêm de e_series_nearest (src/e_series.h).
+const char *resistor_band_color_name(int8_t index);
+
+#endif // RESISTOR_H
@@ -0,0 +1,93 @@
+#include "src/scheduler.h"
+
+static const scheduler_t *scheduler_list[SCHEDULER_MAX_INSTANCES];
+static uint8_t scheduler_list_count = 0;
+
+void scheduler_register(const scheduler_t *scheduler) {
+  if (scheduler_list_count < SCHEDULER_MAX_INSTANCES) {
+    scheduler_list[scheduler_list_count++] = scheduler;
+  }
+}
+
+void scheduler_signal(scheduler_t *scheduler, uint8_t task) {
+  scheduler->tasks[task].pending = true;
+
+  // O flag precisa estar visível antes de o outro núcleo acordar
+  hal_memory_barrier();
+  hal_event_signal();
+}
+
+void scheduler_defer(scheduler_t *scheduler, uint8_t task, uint32_t delay_ms) {
+  scheduler_task_t *t = &scheduler->tasks[task];
+  uint32_t due_ms = hal_time_ms() + delay_ms;
+
+  // Um prazo já agendado mais cedo (período ou outro adiamento) prevalece
+  if ((!t->period_ms && !t->deferred) || (int32_t)(due_ms - t->next_ms) < 0) {
+    t->next_ms = due_ms;
+  }
+  t->deferred = true;
+}
+
+// Executa as tarefas sinalizadas ou vencidas. Retorna quantos milissegundos
+// faltam para a próxima tarefa periódica (0 se alguma tarefa executou).
+static uint32_t scheduler_dispatch(scheduler_t *scheduler) {
+  uint32_t now = hal_time_ms();
+  uint32_t wait_ms = SCHEDULER_IDLE_MAX_MS;
+  bool ran = false;
+
+  for (uint8_t i = 0; i < scheduler->count; i++) {
+    scheduler_task_t *task = &scheduler->tasks[i];
+    bool timed = task->period_ms || task->deferred;
+    bool due = timed && (int32_t)(now - task->next_ms) >= 0;
+
+    if (task->pending || due) {
+      // Limpa antes de executar: um sinal durante a execução não se perde
+      task->pending = false;
+      hal_memory_barrier();
+
+      task->next_ms = now + task->period_ms;
+      task->deferred = false;
+      task->run(now);
+      task->runs++;
+      ran = true;
+      now = hal_time_ms();
+    } else if (timed && task->next_ms - now < wait_ms) {
+      wait_ms = task->next_ms - now;
+    }
+  }
+  return ran ? 0 : wait_ms;
+}
+
+void scheduler_run(scheduler_t *scheduler) {
+  uint32_t now = hal_time_ms();
+  for (uint8_t i = 0; i < scheduler->count; i++) {
+    if (!scheduler->tasks[i].deferred) {
+      scheduler->tasks[i].next_ms = now + scheduler->tasks[i].period_ms;
+    }
+  }
+
+  while (true) {
+    uint32_t wait_ms = scheduler_dispatch(scheduler);
+
+    // Um sinal entre o dispatch e a espera não se perde: ele deixa o evento
+    // pendente (registrador de evento do WFE) e a espera retorna de imediato
+    if (wait_ms) {
+      uint64_t start_us = hal_time_us();
+      hal_event_wait(wait_ms * 1000u);
+
+      // idle_ms é lido pelo outro núcleo: 32 bits, escrito em um único store
+      uint32_t idle_us = scheduler->idle_us_frac + (uint32_t)(hal_time_us() - start_us);
+      scheduler->idle_ms += idle_us / 1000u;
+      scheduler->idle_us_frac = idle_us % 1000u;
+      scheduler->wakeups++;
+    }
+  }
+}
+
+uint8_t scheduler_count(void) {
+  return scheduler_list_count;
+}
+
+const scheduler_t *scheduler_get(uint8_t index) {
+  return scheduler_list[index];
+}
@@ -0,0 +1,79 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/*
+ * Escalonador cooperativo (run-to-completion), um por núcleo.
+ *
+ * Cada tarefa é uma função curta que executa até o fim. Ela roda quando
+ * sinalizada (scheduler_signal, de uma interrupção, de outro núcleo ou de
+ * outra tarefa) e, se tiver período, também quando passar period_ms desde a
+ * última execução. Sem nada a fazer, o núcleo dorme em hal_event_wait (WFE
+ * no RP2040) até o próximo sinal, interrupção ou prazo.
+ *
+ * As tabelas de tarefas são estáticas, definidas por quem usa o escalonador:
+ *
+ *   enum { TASK_A, TASK_B };
+ *   static scheduler_task_t tasks[] = {
+ *     [TASK_A] = { "a", task_a, 0 },     // só por evento
+ *     [TASK_B] = { "b", task_b, 1000 },  // a cada 1 s (e por evento)
+ *   };
+ *   static scheduler_t scheduler = SCHEDULER_INIT("core1", tasks);
+ *
+ * O sinal é um flag por tarefa: sinais repetidos antes da execução viram uma
+ * única execução, então a tarefa deve tratar tudo o que estiver pendente.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hal/hal.h"
+
+// Espera máxima sem tarefas periódicas
+#define SCHEDULER_IDLE_MAX_MS 1000
+
+// Escalonadores acompanhados em /metrics (um por núcleo)
+#define SCHEDULER_MAX_INSTANCES 2
+
+typedef void (*scheduler_fn_t)(uint32_t now_ms);
+
+typedef struct {
+  const char *name;
+  scheduler_fn_t run;
+  uint32_t period_ms;      // 0 = só quando sinalizada
+  uint32_t next_ms;        // próxima execução periódica
+  volatile bool pending;   // sinalizada e ainda não executada
+  bool deferred;           // execução única agendada em next_ms (scheduler_defer)
+  uint32_t runs;
+} scheduler_task_t;
+
+typedef struct {
+  const char *name;
+  scheduler_task_t *tasks;
+  uint8_t count;
+  uint32_t wakeups;        // retornos de hal_event_wait
+  uint32_t idle_ms;        // tempo em hal_event_wait (inclui interrupções atendidas nele)
+  uint32_t idle_us_frac;   // resto em microssegundos ainda não somado a idle_ms
+} scheduler_t;
+
+#define SCHEDULER_INIT(name, tasks) { (name), (tasks), sizeof(tasks) / sizeof((tasks)[0]), 0, 0, 0 }
+
+// Marca a tarefa para execução e acorda o núcleo do escalonador. Pode ser
+// chamada de interrupções e de qualquer núcleo.
+void scheduler_signal(scheduler_t *scheduler, uint8_t task);
+
+// Agenda uma execução da tarefa daqui a delay_ms (ex.: nova tentativa de um
+// recurso ocupado), mesmo sem período. Só pelas tarefas do próprio escalonador.
+void scheduler_defer(scheduler_t *scheduler, uint8_t task, uint32_t delay_ms);
+
+// Inclui o escalonador nas métricas. Chamada pelo núcleo 0 antes de iniciar o
+// núcleo 1, para que a lista não seja alterada pelos dois ao mesmo tempo.
+void scheduler_register(const scheduler_t *scheduler);
+
+// Executa as tarefas no núcleo atual. Não retorna.
+void scheduler_run(scheduler_t *scheduler);
+
+// Escalonadores registrados, para as métricas
+uint8_t scheduler_count(void);
+const scheduler_t *scheduler_get(uint8_t index);
+
+#endif // SCHEDULER_H
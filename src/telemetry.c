@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "hal/hal.h"
+#include "src/measurement.h"
+#include "src/telemetry.h"
+
+#if TELEMETRY_ENABLED
+
+#include "lwip/pbuf.h"
+#include "lwip/udp.h"
+
+static struct udp_pcb *telemetry_pcb = NULL;
+static ip_addr_t telemetry_address;
+
+static uint32_t telemetry_seq = 0;
+static uint32_t telemetry_measurement_seq = 0;
+static uint32_t telemetry_sent_ms = 0;
+
+static inline uint8_t *telemetry_put_u16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  return p + 2;
+}
+
+static inline uint8_t *telemetry_put_u32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+  return p + 4;
+}
+
+static void telemetry_encode(uint8_t packet[TELEMETRY_PACKET_SIZE], const measurement_t *m, uint8_t flags) {
+  uint8_t *p = packet;
+  p = telemetry_put_u16(p, TELEMETRY_MAGIC);
+  *p++ = TELEMETRY_VERSION;
+  *p++ = flags;
+  p = telemetry_put_u32(p, telemetry_seq);
+  p = telemetry_put_u32(p, m->timestamp_ms);
+  p = telemetry_put_u32(p, m->measured);
+  p = telemetry_put_u32(p, m->e24);
+  p = telemetry_put_u32(p, m->samples);
+  for (int i = 0; i < 3; i++) {
+    *p++ = (uint8_t)m->bands[i];
+  }
+  *p++ = m->range;
+}
+
+void telemetry_init(void) {
+  IP4_ADDR(&telemetry_address, TELEMETRY_ADDRESS_A, TELEMETRY_ADDRESS_B, TELEMETRY_ADDRESS_C, TELEMETRY_ADDRESS_D);
+
+  hal_net_lock();
+  telemetry_pcb = udp_new();
+  hal_net_unlock();
+
+  if (!telemetry_pcb) {
+    printf("Falha ao criar o PCB UDP da telemetria\n");
+    return;
+  }
+  printf("Telemetria em udp://%s:%u\n", ipaddr_ntoa(&telemetry_address), (unsigned)TELEMETRY_PORT);
+}
+
+void telemetry_update(uint32_t now_ms) {
+  if (!telemetry_pcb) {
+    return;
+  }
+
+  uint32_t sequence = measurement_sequence();
+  bool fresh = sequence != telemetry_measurement_seq;
+  if (!sequence || (!fresh && now_ms - telemetry_sent_ms < TELEMETRY_REPEAT_MS)) {
+    return;
+  }
+
+  measurement_t m;
+  sequence = measurement_read(&m);
+
+  uint8_t packet[TELEMETRY_PACKET_SIZE];
+  telemetry_seq++;
+  telemetry_encode(packet, &m, fresh ? 0 : TELEMETRY_FLAG_REPEAT);
+
+  // Sem memória ou sem rota o datagrama é descartado: a sequência já avançou,
+  // o receptor vê a lacuna e a medição é repetida no próximo intervalo.
+  // PBUF_RAM porque o lwIP pode reter o datagrama (resolução ARP) após o envio.
+  hal_net_lock();
+  struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, sizeof(packet), PBUF_RAM);
+  if (p) {
+    memcpy(p->payload, packet, sizeof(packet));
+    udp_sendto(telemetry_pcb, p, &telemetry_address, TELEMETRY_PORT);
+    pbuf_free(p);
+  }
+  hal_net_unlock();
+
+  telemetry_measurement_seq = sequence;
+  telemetry_sent_ms = now_ms;
+}
+
+#endif // TELEMETRY_ENABLED
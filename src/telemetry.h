@@ -0,0 +1,66 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+/*
+ * Telemetria por UDP: cada medição publicada (src/measurement.h) é enviada em
+ * um único datagrama para um grupo multicast, de modo que qualquer número de
+ * painéis na rede recebe as leituras pelo custo de um envio, sem conexão nem
+ * resposta HTTP por cliente. A última medição é repetida a cada
+ * TELEMETRY_REPEAT_MS para quem começar a ouvir depois.
+ *
+ * Datagrama de TELEMETRY_PACKET_SIZE bytes, inteiros em little-endian:
+ *   0  u16  TELEMETRY_MAGIC
+ *   2  u8   TELEMETRY_VERSION
+ *   3  u8   flags (TELEMETRY_FLAG_*)
+ *   4  u32  sequência do datagrama (começa em 1 a cada boot, sem lacunas)
+ *   8  u32  timestamp da medição (ms desde o boot)
+ *  12  u32  valor medido (ohms em Q24.8)
+ *  16  u32  valor comercial E24 (ohms em Q24.8)
+ *  20  u32  amostras do ADC usadas na medição
+ *  24  i8   bandas (3 índices de cor, -1 = fora da faixa)
+ *  27  u8   faixa de medição
+ * Uma lacuna na sequência indica datagramas perdidos; uma sequência menor
+ * que a anterior, reinício do dispositivo. tools/telemetry_rx.py recebe e
+ * confere os datagramas.
+ *
+ * Com TELEMETRY_ENABLED=0 (opção TELEMETRY do CMake) nada é compilado.
+ */
+
+#include <stdint.h>
+
+#ifndef TELEMETRY_ENABLED
+#define TELEMETRY_ENABLED 0
+#endif
+
+// Destino: grupo multicast de escopo local. 255.255.255.255 envia por broadcast.
+#define TELEMETRY_ADDRESS_A 239
+#define TELEMETRY_ADDRESS_B 255
+#define TELEMETRY_ADDRESS_C 77
+#define TELEMETRY_ADDRESS_D 77
+#define TELEMETRY_PORT 5077
+
+#define TELEMETRY_REPEAT_MS 5000
+
+#define TELEMETRY_MAGIC 0x4D52      // "RM"
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_PACKET_SIZE 28
+
+#define TELEMETRY_FLAG_REPEAT 0x01  // repetição da medição anterior
+
+#if TELEMETRY_ENABLED
+
+// Cria o PCB UDP. Deve ser chamada pelo núcleo 0 depois de conectar à rede.
+void telemetry_init(void);
+
+// Envia a medição publicada, se for nova, ou a repete a cada
+// TELEMETRY_REPEAT_MS. Chamada pelo núcleo 0 a cada medição e periodicamente.
+void telemetry_update(uint32_t now_ms);
+
+#else
+
+static inline void telemetry_init(void) {}
+static inline void telemetry_update(uint32_t now_ms) { (void)now_ms; }
+
+#endif // TELEMETRY_ENABLED
+
+#endif // TELEMETRY_H
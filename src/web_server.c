@@ -0,0 +1,1090 @@
+#include <stdio.h>               // Biblioteca padrão para entrada e saída
+#include <stdlib.h>
+#include <string.h>              // Biblioteca manipular strings
+#include <strings.h>
+#include <math.h>
+
+#include "hal/hal.h"
+#include "src/web_server.h"
+#include "src/measurement.h"
+#include "src/calibration.h"
+#include "src/flash_log.h"
+#include "src/history.h"
+#include "src/metrics.h"
+#include "web_assets.h"
+
+// Tamanho máximo das respostas geradas (cabeçalho HTTP + conteúdo)
+#define HTTP_JSON_RESPONSE_MAX 256
+#define HTTP_EVENT_MAX 192
+
+// Cabeçalho HTTP e chunk com a base de /api/history (copiados para o lwIP)
+#define HTTP_HISTORY_HEADER_MAX 192
+
+// Resposta de /metrics (cabeçalho HTTP + texto do Prometheus)
+#define HTTP_METRICS_RESPONSE_MAX 10240
+
+// Conexões /events abertas ao mesmo tempo. Cada uma ocupa um PCB de forma
+// permanente, então metade de MEMP_NUM_TCP_PCB fica reservada para requisições comuns.
+#define HTTP_EVENTS_MAX_CLIENTS (MEMP_NUM_TCP_PCB / 2)
+
+// Respostas ainda não confirmadas que uma conexão pode manter enfileiradas
+#define HTTP_CONN_PENDING_MAX 4
+
+// Requisições já lidas aguardando espaço no buffer de envio (pipelining)
+#define HTTP_CONN_QUEUE_MAX 4
+
+// Trecho inicial de cada linha da requisição guardado pelo parser. Linhas
+// maiores (cookies, user-agent) são truncadas, pois só o início interessa.
+#define HTTP_LINE_MAX 64
+
+// Intervalo do tcp_poll em unidades de 500 ms (1 s)
+#define HTTP_POLL_INTERVAL 2
+
+// Conexão keep-alive ociosa é fechada após este tempo
+#define HTTP_IDLE_TIMEOUT_S 5
+
+// Conexão com envio parado (cliente não confirma os dados) é abortada após este tempo
+#define HTTP_STALL_TIMEOUT_S 20
+
+// Sem novas medições, um comentário SSE é enviado para detectar clientes que sumiram
+#define HTTP_EVENTS_HEARTBEAT_S 15
+
+static const char not_found_response[] =
+  "HTTP/1.1 404 Not Found\r\n"
+  "Content-Length: 0\r\n"
+  "\r\n";
+
+// Início do fluxo Server-Sent Events. A conexão permanece aberta e cada nova
+// medição é enviada como uma mensagem "data: <json>".
+static const char events_header[] =
+  "HTTP/1.1 200 OK\r\n"
+  "Content-Type: text/event-stream\r\n"
+  "Cache-Control: no-cache\r\n"
+  "\r\n"
+  "retry: 2000\n\n";
+
+static const char events_heartbeat[] = ":\n\n";
+
+// A calibração é executada pelo núcleo de medição logo em seguida
+static const char accepted_response[] =
+  "HTTP/1.1 202 Accepted\r\n"
+  "Content-Length: 0\r\n"
+  "\r\n";
+
+// Início das respostas binárias de tamanho variável (/api/history e /api/log)
+static const char chunked_header[] =
+  "HTTP/1.1 200 OK\r\n"
+  "Content-Type: application/octet-stream\r\n"
+  "Transfer-Encoding: chunked\r\n"
+  "Cache-Control: no-store\r\n"
+  "\r\n";
+
+// Fim do chunk com as entradas e chunk final (vazio)
+static const char history_trailer[] = "\r\n0\r\n\r\n";
+
+// Tamanho do chunk de cada página de /api/log, em hexadecimal
+#define HTTP_LOG_CHUNK_HEADER "100\r\n"
+_Static_assert(HAL_FLASH_PAGE_SIZE == 0x100, "HTTP_LOG_CHUNK_HEADER deve ser o tamanho da página");
+
+#if METRICS_ENABLED
+// Content-Length com largura fixa: o cabeçalho é escrito depois do corpo
+static const char metrics_header[] =
+  "HTTP/1.1 200 OK\r\n"
+  "Content-Type: text/plain; version=0.0.4\r\n"
+  "Cache-Control: no-store\r\n"
+  "Content-Length: %05u\r\n"
+  "\r\n";
+#endif
+
+static const char unavailable_response[] =
+  "HTTP/1.1 503 Service Unavailable\r\n"
+  "Retry-After: 5\r\n"
+  "Content-Length: 0\r\n"
+  "\r\n";
+
+/*
+ * Todas as respostas são enviadas sem cópia (tcp_write sem TCP_WRITE_FLAG_COPY),
+ * então o lwIP referencia o buffer até receber o ACK.
+ *
+ * A página (HTML, CSS e JS) vem pronta da flash: tools/web_assets.py gera, na
+ * compilação, as respostas completas de cada arquivo de web/ com e sem gzip e
+ * a resposta 304, com ETag e Cache-Control. Como o CSS e o JS têm o hash do
+ * conteúdo no caminho, o navegador os guarda sem revalidar; o HTML é
+ * revalidado a cada carga e normalmente responde 304 sem corpo. Depois disso
+ * só trafegam as medições (/events ou /api/measurement).
+ *
+ * As respostas de erro também não mudam. A medição (resposta JSON e
+ * mensagem SSE) é renderizada pela tarefa publish do núcleo 0 uma única vez a
+ * cada nova medição em um de dois conjuntos de buffers: o ativo é entregue às conexões e
+ * o outro só é reescrito quando nenhuma conexão possui mais bytes dele
+ * pendentes de confirmação.
+ *
+ * Respostas maiores que TCP_SND_BUF (/metrics) são escritas em partes, à
+ * medida que o buffer de envio esvazia (http_conn_stream_response).
+ */
+typedef enum {
+  HTTP_RESPONSE_MEASUREMENT_0 = 0,
+  HTTP_RESPONSE_MEASUREMENT_1,
+  HTTP_RESPONSE_EVENT_0,
+  HTTP_RESPONSE_EVENT_1,
+  HTTP_RESPONSE_NOT_FOUND,
+  HTTP_RESPONSE_EVENTS_HEADER,
+  HTTP_RESPONSE_EVENTS_HEARTBEAT,
+  HTTP_RESPONSE_UNAVAILABLE,
+  HTTP_RESPONSE_ACCEPTED,
+  HTTP_RESPONSE_HISTORY_TRAILER,
+  HTTP_RESPONSE_CHUNKED_HEADER,
+  HTTP_RESPONSE_LAST_CHUNK,
+#if METRICS_ENABLED
+  HTTP_RESPONSE_METRICS,
+#endif
+  HTTP_RESPONSE_ASSETS,   // WEB_ASSET_VARIANTS respostas de cada arquivo de web_assets
+  HTTP_RESPONSE_COPIED = HTTP_RESPONSE_ASSETS + WEB_ASSET_COUNT * WEB_ASSET_VARIANTS,  // dados copiados pelo lwIP (sem buffer próprio)
+  HTTP_RESPONSE_HISTORY,  // bytes do histórico (src/history.h), enviados sem cópia
+  HTTP_RESPONSE_COUNT
+} http_response_id_t;
+
+// Recursos atendidos pelo servidor. A resposta de cada rota só é escolhida no
+// momento do envio, para que a medição enviada seja sempre a mais recente.
+typedef enum {
+  HTTP_ROUTE_ASSET = 0,      // arquivo estático (web_assets)
+  HTTP_ROUTE_MEASUREMENT,
+  HTTP_ROUTE_EVENTS,
+  HTTP_ROUTE_HISTORY,        // GET /api/history?since=<seq>
+  HTTP_ROUTE_LOG,            // GET /api/log
+  HTTP_ROUTE_METRICS,        // GET /metrics
+  HTTP_ROUTE_CALIBRATE,      // POST /api/calibrate
+  HTTP_ROUTE_CALIBRATE_DNL,  // POST /api/calibrate?dnl=1
+  HTTP_ROUTE_NOT_FOUND
+} http_route_t;
+
+typedef struct {
+  const char *data;
+  u16_t len;
+  u8_t refs; // envios deste buffer ainda não confirmados
+} http_response_t;
+
+// Parser incremental: processa a requisição byte a byte, mesmo que ela chegue
+// dividida em vários segmentos/pbufs, sem armazená-la por inteiro
+typedef struct {
+  char line[HTTP_LINE_MAX];
+  u8_t line_len;
+  bool in_headers;    // linha de requisição lida, aguardando o fim dos cabeçalhos
+  http_route_t route;
+  bool close;         // "Connection: close" ou HTTP/1.0 sem keep-alive
+  bool may_have_body; // não é GET: o corpo não é pulado, a conexão sempre fecha
+  uint32_t since;     // parâmetro since de /api/history
+  u8_t asset;         // índice em web_assets (HTTP_ROUTE_ASSET)
+  bool gzip;          // "Accept-Encoding: gzip"
+  bool not_modified;  // If-None-Match com o ETag atual do arquivo
+} http_parser_t;
+
+// Estado por conexão, alocado de um pool fixo do tamanho do pool de PCBs
+typedef struct {
+  struct tcp_pcb *pcb;
+  bool events;        // conexão inscrita em /events
+  bool event_stale;   // chegou uma medição enquanto o envio anterior estava pendente
+  bool closing;       // fechar assim que as respostas forem confirmadas
+  u8_t idle_s;        // segundos sem receber nem ter dados confirmados
+  http_parser_t parser;
+  u8_t queued_count;
+  struct {
+    u8_t route;
+    u8_t response;    // resposta escolhida na leitura (HTTP_ROUTE_ASSET)
+  } queued[HTTP_CONN_QUEUE_MAX];
+  u8_t pending_count; // respostas enviadas e ainda não confirmadas, em ordem
+  struct {
+    u8_t response;
+    u16_t remaining;
+  } pending[HTTP_CONN_PENDING_MAX];
+
+  // Resposta maior que o buffer de envio sendo escrita em partes. A conexão
+  // mantém uma referência ao buffer até escrever o último byte.
+  bool response_active;
+  u8_t response_id;
+  u16_t response_pos;
+
+  // Envio de /api/history: as posições [history_acked, history_end) do
+  // histórico ainda são referenciadas pela conexão e não podem ser
+  // sobrescritas. Requisições em pipeline usam o since da última.
+  uint32_t history_since;
+  bool history_active;  // há bytes do histórico ainda não escritos
+  uint32_t history_pos;
+  uint32_t history_end;
+  uint32_t history_acked;
+
+  // Envio de /api/log: próxima página e fim do trecho. As páginas são
+  // copiadas para o lwIP, pois o núcleo 1 pode apagá-las a qualquer momento.
+  bool log_active;
+  uint32_t log_seq;
+  uint32_t log_end;
+} http_conn_t;
+
+static char measurement_response[2][HTTP_JSON_RESPONSE_MAX];
+static char measurement_event[2][HTTP_EVENT_MAX];
+#if METRICS_ENABLED
+static char metrics_response[HTTP_METRICS_RESPONSE_MAX];
+#endif
+
+static http_response_t responses[HTTP_RESPONSE_COUNT] = {
+  [HTTP_RESPONSE_MEASUREMENT_0] = { measurement_response[0], 0, 0 },
+  [HTTP_RESPONSE_MEASUREMENT_1] = { measurement_response[1], 0, 0 },
+  [HTTP_RESPONSE_EVENT_0]       = { measurement_event[0], 0, 0 },
+  [HTTP_RESPONSE_EVENT_1]       = { measurement_event[1], 0, 0 },
+  [HTTP_RESPONSE_NOT_FOUND]     = { not_found_response, sizeof(not_found_response) - 1, 0 },
+  [HTTP_RESPONSE_EVENTS_HEADER] = { events_header, sizeof(events_header) - 1, 0 },
+  [HTTP_RESPONSE_EVENTS_HEARTBEAT] = { events_heartbeat, sizeof(events_heartbeat) - 1, 0 },
+  [HTTP_RESPONSE_UNAVAILABLE]   = { unavailable_response, sizeof(unavailable_response) - 1, 0 },
+  [HTTP_RESPONSE_ACCEPTED]      = { accepted_response, sizeof(accepted_response) - 1, 0 },
+  [HTTP_RESPONSE_HISTORY_TRAILER] = { history_trailer, sizeof(history_trailer) - 1, 0 },
+  [HTTP_RESPONSE_CHUNKED_HEADER] = { chunked_header, sizeof(chunked_header) - 1, 0 },
+  [HTTP_RESPONSE_LAST_CHUNK]    = { history_trailer + 2, sizeof(history_trailer) - 3, 0 },
+#if METRICS_ENABLED
+  [HTTP_RESPONSE_METRICS]       = { metrics_response, 0, 0 },
+#endif
+};
+
+// Índice (0 ou 1) do conjunto de buffers de medição ativo
+static volatile u8_t active_measurement = 0;
+static http_conn_t connections[MEMP_NUM_TCP_PCB];
+
+// Valores usados na última renderização
+static bool measurement_rendered = false;
+static uint32_t checked_sequence = 0;
+static long rendered_measured = 0;
+static long rendered_commercial = 0;
+static int8_t rendered_bands[3] = {0};
+static uint8_t rendered_range = 0;
+
+static err_t tcp_server_sent(void *arg, struct tcp_pcb *tpcb, u16_t len);
+static err_t tcp_server_poll(void *arg, struct tcp_pcb *tpcb);
+static void tcp_server_err(void *arg, err_t err);
+
+static http_conn_t *http_conn_alloc(struct tcp_pcb *pcb) {
+  for (int i = 0; i < MEMP_NUM_TCP_PCB; i++) {
+    if (!connections[i].pcb) {
+      memset(&connections[i], 0, sizeof(connections[i]));
+      connections[i].pcb = pcb;
+      return &connections[i];
+    }
+  }
+  return NULL;
+}
+
+// Libera as referências aos buffers de resposta e o estado da conexão
+static void http_conn_free(http_conn_t *conn) {
+  for (u8_t i = 0; i < conn->pending_count; i++) {
+    responses[conn->pending[i].response].refs--;
+  }
+  if (conn->response_active) {
+    responses[conn->response_id].refs--;
+    conn->response_active = false;
+  }
+  conn->pending_count = 0;
+  conn->queued_count = 0;
+  conn->events = false;
+  conn->pcb = NULL;
+}
+
+// Fecha a conexão. Só deve ser chamada sem respostas pendentes de confirmação,
+// pois o lwIP ainda pode retransmitir dados referenciados após o tcp_close.
+// Retorna ERR_ABRT se o PCB precisou ser abortado.
+static err_t http_conn_close(http_conn_t *conn) {
+  struct tcp_pcb *pcb = conn->pcb;
+
+  tcp_arg(pcb, NULL);
+  tcp_recv(pcb, NULL);
+  tcp_sent(pcb, NULL);
+  tcp_poll(pcb, NULL, 0);
+  tcp_err(pcb, NULL);
+  http_conn_free(conn);
+
+  if (tcp_close(pcb) != ERR_OK) {
+    tcp_abort(pcb);
+    return ERR_ABRT;
+  }
+  return ERR_OK;
+}
+
+// Descarta a conexão com RST. O lwIP libera os dados enfileirados e chama
+// tcp_server_err, que libera o estado da conexão.
+static err_t http_conn_abort(http_conn_t *conn) {
+  tcp_abort(conn->pcb);
+  return ERR_ABRT;
+}
+
+// Fecha a conexão marcada para fechamento quando não houver mais nada a enviar
+static err_t http_conn_try_close(http_conn_t *conn) {
+  if (conn->closing && !conn->queued_count && !conn->pending_count && !conn->response_active &&
+      !conn->history_active && !conn->log_active) {
+    return http_conn_close(conn);
+  }
+  return ERR_OK;
+}
+
+// Registra bytes escritos no lwIP e ainda não confirmados. Trechos seguidos
+// do mesmo tipo ocupam uma única posição da fila.
+static void http_conn_add_pending(http_conn_t *conn, http_response_id_t id, u16_t len) {
+  if (conn->pending_count &&
+      conn->pending[conn->pending_count - 1].response == id &&
+      conn->pending[conn->pending_count - 1].remaining <= UINT16_MAX - len) {
+    conn->pending[conn->pending_count - 1].remaining += len;
+    return;
+  }
+
+  conn->pending[conn->pending_count].response = id;
+  conn->pending[conn->pending_count].remaining = len;
+  conn->pending_count++;
+  responses[id].refs++;
+}
+
+// Indica se ainda cabe um trecho do tipo id na fila de pendentes
+static bool http_conn_can_add_pending(const http_conn_t *conn, http_response_id_t id) {
+  return conn->pending_count < HTTP_CONN_PENDING_MAX ||
+         conn->pending[conn->pending_count - 1].response == id;
+}
+
+// Escreve o restante de uma resposta grande, sem cópia, enquanto houver
+// espaço no buffer de envio. Retorna true se escreveu algo.
+static bool http_conn_stream_response(http_conn_t *conn) {
+  bool written = false;
+
+  while (conn->response_active) {
+    http_response_t *response = &responses[conn->response_id];
+    u16_t remaining = response->len - conn->response_pos;
+    if (!remaining) {
+      response->refs--;
+      conn->response_active = false;
+      break;
+    }
+
+    u16_t len = tcp_sndbuf(conn->pcb);
+    if (len > remaining) {
+      len = remaining;
+    }
+    if (!len || !http_conn_can_add_pending(conn, conn->response_id) ||
+        tcp_write(conn->pcb, response->data + conn->response_pos, len,
+                  len < remaining ? TCP_WRITE_FLAG_MORE : 0) != ERR_OK) {
+      break;
+    }
+
+    http_conn_add_pending(conn, conn->response_id, len);
+    conn->response_pos += len;
+    written = true;
+  }
+  return written;
+}
+
+// Envia uma resposta sem cópia e registra os bytes pendentes de confirmação
+static err_t http_conn_send(http_conn_t *conn, http_response_id_t id) {
+  const http_response_t *response = &responses[id];
+
+  if (!response->len || conn->pending_count >= HTTP_CONN_PENDING_MAX) {
+    return ERR_MEM;
+  }
+
+  // Nunca caberia de uma vez: segue em partes a partir de agora
+  if (response->len > TCP_SND_BUF) {
+    responses[id].refs++;
+    conn->response_active = true;
+    conn->response_id = id;
+    conn->response_pos = 0;
+    http_conn_stream_response(conn);
+    return ERR_OK;
+  }
+
+  err_t err = tcp_write(conn->pcb, response->data, response->len, 0);
+  if (err != ERR_OK) {
+    return err;
+  }
+
+  http_conn_add_pending(conn, id, response->len);
+  return ERR_OK;
+}
+
+// Inicia a resposta de /api/history: cabeçalho HTTP e um chunk com a base
+// (sequência, timestamp e valor medido da entrada anterior à primeira
+// enviada, seguidos da quantidade de entradas, em varints). As entradas vão
+// em um segundo chunk, escrito por http_conn_stream_history.
+static err_t http_conn_start_history(http_conn_t *conn) {
+  history_range_t range;
+  history_find(conn->history_since, &range);
+
+  uint8_t base[4 * 5];
+  u16_t base_len = 0;
+  base_len += history_put_varint(base + base_len, range.base.seq);
+  base_len += history_put_varint(base + base_len, range.base.timestamp_ms);
+  base_len += history_put_varint(base + base_len, range.base.measured);
+  base_len += history_put_varint(base + base_len, range.count);
+
+  char header[HTTP_HISTORY_HEADER_MAX];
+  int len = snprintf(header, sizeof(header), "%s%x\r\n", chunked_header, (unsigned)base_len);
+  memcpy(header + len, base, base_len);
+  len += base_len;
+
+  uint32_t data_len = range.end - range.start;
+  if (data_len) {
+    len += snprintf(header + len, sizeof(header) - len, "\r\n%lx\r\n", (unsigned long)data_len);
+  } else {
+    len += snprintf(header + len, sizeof(header) - len, "\r\n0\r\n\r\n");
+  }
+
+  if (!http_conn_can_add_pending(conn, HTTP_RESPONSE_COPIED)) {
+    return ERR_MEM;
+  }
+  err_t err = tcp_write(conn->pcb, header, (u16_t)len, TCP_WRITE_FLAG_COPY);
+  if (err != ERR_OK) {
+    return err;
+  }
+  http_conn_add_pending(conn, HTTP_RESPONSE_COPIED, (u16_t)len);
+
+  conn->history_active = data_len != 0;
+  conn->history_pos = range.start;
+  conn->history_end = range.end;
+  conn->history_acked = range.start;
+  return ERR_OK;
+}
+
+// Escreve as entradas do histórico direto do buffer circular, sem cópia,
+// enquanto houver espaço no buffer de envio. Retorna true se escreveu algo.
+static bool http_conn_stream_history(http_conn_t *conn) {
+  bool written = false;
+
+  while (conn->history_active) {
+    if (conn->history_pos == conn->history_end) {
+      if (http_conn_send(conn, HTTP_RESPONSE_HISTORY_TRAILER) != ERR_OK) {
+        break;
+      }
+      conn->history_active = false;
+      written = true;
+      break;
+    }
+
+    uint32_t len;
+    const uint8_t *data = history_data(conn->history_pos, conn->history_end, &len);
+    u16_t space = tcp_sndbuf(conn->pcb);
+    if (len > space) {
+      len = space;
+    }
+    if (!len || !http_conn_can_add_pending(conn, HTTP_RESPONSE_HISTORY) ||
+        tcp_write(conn->pcb, data, (u16_t)len, TCP_WRITE_FLAG_MORE) != ERR_OK) {
+      break;
+    }
+
+    http_conn_add_pending(conn, HTTP_RESPONSE_HISTORY, (u16_t)len);
+    conn->history_pos += len;
+    written = true;
+  }
+  return written;
+}
+
+// Escreve as páginas do registro na flash, uma por chunk, enquanto houver
+// espaço no buffer de envio. Páginas apagadas ou corrompidas são puladas (o
+// cliente percebe a lacuna pela sequência). Retorna true se escreveu algo.
+static bool http_conn_stream_log(http_conn_t *conn) {
+  bool written = false;
+  uint8_t chunk[sizeof(HTTP_LOG_CHUNK_HEADER) - 1 + HAL_FLASH_PAGE_SIZE + 2];
+  const u16_t page_start = sizeof(HTTP_LOG_CHUNK_HEADER) - 1;
+
+  while (conn->log_active) {
+    if (conn->log_seq == conn->log_end) {
+      if (http_conn_send(conn, HTTP_RESPONSE_LAST_CHUNK) != ERR_OK) {
+        break;
+      }
+      conn->log_active = false;
+      written = true;
+      break;
+    }
+
+    if (tcp_sndbuf(conn->pcb) < sizeof(chunk) || !http_conn_can_add_pending(conn, HTTP_RESPONSE_COPIED)) {
+      break;
+    }
+    if (!flash_log_read_page(conn->log_seq, chunk + page_start)) {
+      conn->log_seq++;
+      continue;
+    }
+
+    memcpy(chunk, HTTP_LOG_CHUNK_HEADER, page_start);
+    memcpy(chunk + page_start + HAL_FLASH_PAGE_SIZE, "\r\n", 2);
+    if (tcp_write(conn->pcb, chunk, sizeof(chunk), TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE) != ERR_OK) {
+      break;
+    }
+
+    http_conn_add_pending(conn, HTTP_RESPONSE_COPIED, sizeof(chunk));
+    conn->log_seq++;
+    written = true;
+  }
+  return written;
+}
+
+// Envia a medição mais recente a um cliente de /events. Enquanto o envio
+// anterior não for confirmado, as medições intermediárias são descartadas e
+// apenas a última é enviada quando o cliente voltar a ter espaço.
+static void http_conn_send_event(http_conn_t *conn) {
+  if (conn->pending_count || http_conn_send(conn, HTTP_RESPONSE_EVENT_0 + active_measurement) != ERR_OK) {
+    conn->event_stale = true;
+    return;
+  }
+
+  conn->event_stale = false;
+  tcp_output(conn->pcb);
+}
+
+static u8_t http_events_clients(void) {
+  u8_t count = 0;
+  for (int i = 0; i < MEMP_NUM_TCP_PCB; i++) {
+    if (connections[i].pcb && connections[i].events) {
+      count++;
+    }
+  }
+  return count;
+}
+
+// Compara o caminho da linha de requisição ("GET <path> HTTP/1.1"), ignorando a query string
+static bool http_path_is(const char *path, const char *expected) {
+  size_t len = strlen(expected);
+  return strncmp(path, expected, len) == 0 &&
+         (path[len] == ' ' || path[len] == '?' || path[len] == '\0');
+}
+
+// Seleciona a rota a partir da linha de requisição ("GET <path> HTTP/1.1").
+// Para HTTP_ROUTE_ASSET, asset recebe o índice do arquivo em web_assets.
+static http_route_t http_route(const char *request_line, u8_t *asset) {
+  if (strncmp(request_line, "POST ", 5) == 0) {
+    const char *path = request_line + 5;
+    if (http_path_is(path, "/api/calibrate")) {
+      return strncmp(path, "/api/calibrate?dnl=1", 20) == 0 ? HTTP_ROUTE_CALIBRATE_DNL : HTTP_ROUTE_CALIBRATE;
+    }
+    return HTTP_ROUTE_NOT_FOUND;
+  }
+  if (strncmp(request_line, "GET ", 4) != 0) {
+    return HTTP_ROUTE_NOT_FOUND;
+  }
+
+  const char *path = request_line + 4;
+  if (http_path_is(path, "/api/measurement")) {
+    return HTTP_ROUTE_MEASUREMENT;
+  }
+  if (http_path_is(path, "/api/history")) {
+    return HTTP_ROUTE_HISTORY;
+  }
+  if (http_path_is(path, "/api/log")) {
+    return HTTP_ROUTE_LOG;
+  }
+  if (http_path_is(path, "/events")) {
+    return HTTP_ROUTE_EVENTS;
+  }
+  if (http_path_is(path, "/metrics")) {
+    return HTTP_ROUTE_METRICS;
+  }
+  if (http_path_is(path, "/index.html")) {
+    path = "/";
+  }
+  for (u8_t i = 0; i < WEB_ASSET_COUNT; i++) {
+    if (http_path_is(path, web_assets[i].path)) {
+      *asset = i;
+      return HTTP_ROUTE_ASSET;
+    }
+  }
+  return HTTP_ROUTE_NOT_FOUND;
+}
+
+// Verifica se o valor de um cabeçalho contém o token (sem diferenciar maiúsculas)
+static bool http_header_has_token(const char *value, const char *token) {
+  size_t len = strlen(token);
+  for (; *value; value++) {
+    if (strncasecmp(value, token, len) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Resposta de um arquivo estático conforme os cabeçalhos da requisição
+static http_response_id_t http_asset_response(const http_parser_t *parser) {
+  web_asset_variant_t variant = parser->not_modified ? WEB_ASSET_NOT_MODIFIED
+                              : parser->gzip ? WEB_ASSET_GZIP
+                              : WEB_ASSET_IDENTITY;
+  return HTTP_RESPONSE_ASSETS + parser->asset * WEB_ASSET_VARIANTS + variant;
+}
+
+// Enfileira a resposta de uma requisição completa
+static void http_conn_enqueue(http_conn_t *conn, http_route_t route) {
+  if (conn->queued_count >= HTTP_CONN_QUEUE_MAX) {
+    // Pipelining além do suportado: responde o que já foi lido e fecha
+    conn->closing = true;
+    return;
+  }
+  conn->queued[conn->queued_count].route = route;
+  conn->queued[conn->queued_count].response = route == HTTP_ROUTE_ASSET ? http_asset_response(&conn->parser) : 0;
+  conn->queued_count++;
+  if (route == HTTP_ROUTE_HISTORY) {
+    conn->history_since = conn->parser.since;
+  }
+}
+
+// Remove a primeira requisição da fila (já respondida)
+static void http_conn_dequeue(http_conn_t *conn) {
+  conn->queued_count--;
+  memmove(conn->queued, conn->queued + 1, conn->queued_count * sizeof(conn->queued[0]));
+}
+
+// Trata uma linha completa (sem o "\r\n") da requisição
+static void http_parser_line(http_conn_t *conn) {
+  http_parser_t *parser = &conn->parser;
+
+  if (!parser->in_headers) {
+    // Linhas vazias antes da linha de requisição são ignoradas
+    if (!parser->line_len) {
+      return;
+    }
+    parser->in_headers = true;
+    parser->route = http_route(parser->line, &parser->asset);
+    parser->gzip = false;
+    parser->not_modified = false;
+
+    const char *since = strstr(parser->line, "since=");
+    parser->since = since ? (uint32_t)strtoul(since + 6, NULL, 10) : 0;
+
+    // HTTP/1.0 fecha a conexão por padrão. Requisições que não são GET podem ter
+    // corpo, que o parser não sabe pular, então a conexão também é fechada
+    // (independente de "Connection: keep-alive": senão o corpo seria lido
+    // como a próxima requisição).
+    parser->close = strstr(parser->line, " HTTP/1.0") != NULL;
+    parser->may_have_body = strncmp(parser->line, "GET ", 4) != 0;
+    return;
+  }
+
+  if (parser->line_len) {
+    if (strncasecmp(parser->line, "Connection:", 11) == 0) {
+      if (http_header_has_token(parser->line + 11, "close")) {
+        parser->close = true;
+      } else if (http_header_has_token(parser->line + 11, "keep-alive")) {
+        parser->close = false;
+      }
+    } else if (strncasecmp(parser->line, "Accept-Encoding:", 16) == 0) {
+      parser->gzip = http_header_has_token(parser->line + 16, "gzip");
+    } else if (parser->route == HTTP_ROUTE_ASSET && strncasecmp(parser->line, "If-None-Match:", 14) == 0) {
+      parser->not_modified = strstr(parser->line + 14, web_assets[parser->asset].hash) != NULL ||
+                             http_header_has_token(parser->line + 14, "*");
+    }
+    return;
+  }
+
+  // Linha vazia: fim dos cabeçalhos, a requisição está completa
+  parser->in_headers = false;
+  http_conn_enqueue(conn, parser->route);
+  if (parser->close || parser->may_have_body) {
+    conn->closing = true;
+  }
+}
+
+// Processa todos os bytes da cadeia de pbufs (p->tot_len)
+static void http_conn_parse(http_conn_t *conn, const struct pbuf *p) {
+  http_parser_t *parser = &conn->parser;
+
+  for (const struct pbuf *q = p; q; q = q->next) {
+    const char *data = (const char *)q->payload;
+
+    for (u16_t i = 0; i < q->len; i++) {
+      // Após "Connection: close" ou /events, o restante é ignorado
+      if (conn->closing || conn->events) {
+        return;
+      }
+
+      char c = data[i];
+      if (c == '\r') {
+        continue;
+      }
+      if (c != '\n') {
+        if (parser->line_len < HTTP_LINE_MAX - 1) {
+          parser->line[parser->line_len++] = c;
+        }
+        continue;
+      }
+
+      parser->line[parser->line_len] = '\0';
+      http_parser_line(conn);
+      parser->line_len = 0;
+    }
+  }
+}
+
+#if METRICS_ENABLED
+// Renderiza /metrics, a menos que outra conexão ainda esteja enviando a
+// renderização anterior (ela é reaproveitada). Retorna false se não coube.
+static bool http_render_metrics(void) {
+  if (responses[HTTP_RESPONSE_METRICS].refs) {
+    return true;
+  }
+
+  char header[sizeof(metrics_header) + 8];
+  int header_len = snprintf(header, sizeof(header), metrics_header, 0u);
+  int body_len = metrics_render(metrics_response + header_len, sizeof(metrics_response) - header_len);
+  if (body_len < 0 || header_len + body_len > UINT16_MAX) {
+    printf("Métricas excedem %d bytes\n", HTTP_METRICS_RESPONSE_MAX);
+    responses[HTTP_RESPONSE_METRICS].len = 0;
+    return false;
+  }
+
+  snprintf(header, sizeof(header), metrics_header, (unsigned)body_len);
+  memcpy(metrics_response, header, header_len);
+  responses[HTTP_RESPONSE_METRICS].len = (u16_t)(header_len + body_len);
+  return true;
+}
+#endif
+
+// Envia as respostas enfileiradas enquanto houver espaço no buffer de envio
+static void http_conn_flush(http_conn_t *conn) {
+  // Uma resposta em partes, /api/history ou /api/log em andamento termina
+  // antes das próximas respostas
+  bool written = http_conn_stream_response(conn);
+  written |= http_conn_stream_history(conn);
+  written |= http_conn_stream_log(conn);
+
+  while (conn->queued_count && !conn->events && !conn->response_active &&
+         !conn->history_active && !conn->log_active) {
+    http_route_t route = (http_route_t)conn->queued[0].route;
+    http_response_id_t id;
+
+    if (route == HTTP_ROUTE_HISTORY) {
+      if (http_conn_start_history(conn) != ERR_OK) {
+        break;
+      }
+      http_conn_dequeue(conn);
+      written = true;
+      http_conn_stream_history(conn);
+      continue;
+    }
+
+    switch (route) {
+      case HTTP_ROUTE_ASSET:
+        id = (http_response_id_t)conn->queued[0].response;
+        break;
+      case HTTP_ROUTE_MEASUREMENT:
+        // Nenhuma leitura estável publicada ainda (ex.: pontas abertas): 503
+        // imediato em vez de segurar a conexão até haver uma
+        id = HTTP_RESPONSE_MEASUREMENT_0 + active_measurement;
+        if (!responses[id].len) {
+          id = HTTP_RESPONSE_UNAVAILABLE;
+        }
+        break;
+      case HTTP_ROUTE_EVENTS:
+        id = http_events_clients() < HTTP_EVENTS_MAX_CLIENTS ? HTTP_RESPONSE_EVENTS_HEADER : HTTP_RESPONSE_UNAVAILABLE;
+        break;
+      case HTTP_ROUTE_CALIBRATE:
+      case HTTP_ROUTE_CALIBRATE_DNL:
+        id = HTTP_RESPONSE_ACCEPTED;
+        break;
+      case HTTP_ROUTE_LOG:
+        id = HTTP_RESPONSE_CHUNKED_HEADER;
+        break;
+#if METRICS_ENABLED
+      case HTTP_ROUTE_METRICS:
+        id = http_render_metrics() ? HTTP_RESPONSE_METRICS : HTTP_RESPONSE_UNAVAILABLE;
+        break;
+#endif
+      default:
+        id = HTTP_RESPONSE_NOT_FOUND;
+        break;
+    }
+
+    // Sem espaço: tenta novamente no sent ou no poll
+    if (http_conn_send(conn, id) != ERR_OK) {
+      break;
+    }
+    written = true;
+
+    if (route == HTTP_ROUTE_CALIBRATE || route == HTTP_ROUTE_CALIBRATE_DNL) {
+      calibration_request(route == HTTP_ROUTE_CALIBRATE_DNL);
+    }
+
+    http_conn_dequeue(conn);
+
+    if (route == HTTP_ROUTE_LOG) {
+      // Páginas gravadas até agora; as seguintes ficam para a próxima requisição
+      flash_log_range(&conn->log_seq, &conn->log_end);
+      conn->log_active = true;
+      http_conn_stream_log(conn);
+    }
+
+    if (id == HTTP_RESPONSE_EVENTS_HEADER) {
+      // A partir daqui a conexão só recebe mensagens SSE, começando pela medição atual
+      conn->events = true;
+      conn->event_stale = true;
+      conn->closing = false;
+      conn->queued_count = 0;
+    }
+  }
+
+  if (written) {
+    tcp_output(conn->pcb);
+  }
+}
+
+// Fecha a conexão keep-alive mais ociosa (há pelo menos um tcp_poll) quando o
+// pool de conexões lota, deixando um PCB livre para o próximo cliente
+static void http_reap_idle_connection(const http_conn_t *except) {
+  http_conn_t *victim = NULL;
+
+  for (int i = 0; i < MEMP_NUM_TCP_PCB; i++) {
+    http_conn_t *conn = &connections[i];
+    if (!conn->pcb) {
+      return; // ainda há conexões livres
+    }
+    if (conn == except || conn->events || conn->pending_count || conn->queued_count ||
+        conn->response_active || conn->history_active || conn->log_active || !conn->idle_s) {
+      continue;
+    }
+    if (!victim || conn->idle_s > victim->idle_s) {
+      victim = conn;
+    }
+  }
+
+  if (victim) {
+    http_conn_close(victim);
+  }
+}
+
+void web_server_init(void) {
+  // Respostas dos arquivos estáticos, já prontas na flash
+  for (int i = 0; i < WEB_ASSET_COUNT; i++) {
+    for (int v = 0; v < WEB_ASSET_VARIANTS; v++) {
+      http_response_t *response = &responses[HTTP_RESPONSE_ASSETS + i * WEB_ASSET_VARIANTS + v];
+      response->data = (const char *)web_assets[i].response[v];
+      response->len = web_assets[i].len[v];
+    }
+  }
+}
+
+// Passa para o histórico as medições enfileiradas pelo núcleo 1. Conexões
+// que ainda referenciam bytes sobrescritos são abortadas antes que o lwIP
+// volte a ler o buffer (retransmissões).
+static void web_server_update_history(void) {
+  hal_net_lock();
+  uint32_t tail = history_drain();
+
+  for (int i = 0; i < MEMP_NUM_TCP_PCB; i++) {
+    http_conn_t *conn = &connections[i];
+    if (conn->pcb && conn->history_acked != conn->history_end && (int32_t)(conn->history_acked - tail) < 0) {
+      http_conn_abort(conn);
+    }
+  }
+  hal_net_unlock();
+}
+
+void web_server_update_response(void) {
+  web_server_update_history();
+
+  // Nenhuma medição nova publicada pelo núcleo de aquisição
+  if (measurement_sequence() == checked_sequence) {
+    return;
+  }
+
+  measurement_t m;
+  uint32_t sequence = measurement_read(&m);
+  long measured = ohms_q8_round(m.measured);
+  long commercial = ohms_q8_round(m.e24);
+
+  // Só renderiza novamente quando algum valor exibido mudou
+  if (measurement_rendered &&
+      measured == rendered_measured &&
+      commercial == rendered_commercial &&
+      memcmp(rendered_bands, m.bands, sizeof(rendered_bands)) == 0 &&
+      m.range == rendered_range) {
+    checked_sequence = sequence;
+    return;
+  }
+
+  u8_t back = active_measurement ^ 1;
+
+  hal_net_lock();
+  bool back_busy = responses[HTTP_RESPONSE_MEASUREMENT_0 + back].refs != 0 ||
+                   responses[HTTP_RESPONSE_EVENT_0 + back].refs != 0;
+  hal_net_unlock();
+
+  // Algum cliente lento ainda referencia o buffer: tenta na próxima medição
+  if (back_busy) {
+    return;
+  }
+
+  // Formatação só com inteiros (uma casa decimal a partir dos décimos de ohm)
+  uint32_t measured_tenths = ohms_q8_tenths(m.measured);
+
+  char body[160];
+  int body_len = snprintf(body, sizeof(body),
+      "{\"measured\":%lu.%lu,\"e24\":%lu,\"bands\":[%d,%d,%d],\"range\":%u,\"samples\":%lu,\"timestamp_ms\":%lu}",
+      (unsigned long)(measured_tenths / 10),
+      (unsigned long)(measured_tenths % 10),
+      (unsigned long)commercial,
+      m.bands[0],
+      m.bands[1],
+      m.bands[2],
+      (unsigned)m.range,
+      (unsigned long)m.samples,
+      (unsigned long)m.timestamp_ms
+  );
+
+  int event_len = snprintf(measurement_event[back], HTTP_EVENT_MAX,
+      "id: %lu\n"
+      "data: %s\n\n",
+      (unsigned long)m.timestamp_ms, body);
+
+  int len = snprintf(measurement_response[back], HTTP_JSON_RESPONSE_MAX,
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Type: application/json\r\n"
+      "Cache-Control: no-store\r\n"
+      "Content-Length: %d\r\n"
+      "\r\n"
+      "%s",
+      body_len, body);
+
+  if (body_len <= 0 || len <= 0 || len >= HTTP_JSON_RESPONSE_MAX ||
+      event_len <= 0 || event_len >= HTTP_EVENT_MAX) {
+    printf("Resposta JSON excede %d bytes\n", HTTP_JSON_RESPONSE_MAX);
+    return;
+  }
+  responses[HTTP_RESPONSE_MEASUREMENT_0 + back].len = (u16_t)len;
+  responses[HTTP_RESPONSE_EVENT_0 + back].len = (u16_t)event_len;
+
+  hal_net_lock();
+  active_measurement = back;
+
+  // Publica a nova medição para os clientes de /events
+  for (int i = 0; i < MEMP_NUM_TCP_PCB; i++) {
+    if (connections[i].pcb && connections[i].events) {
+      http_conn_send_event(&connections[i]);
+    }
+  }
+  hal_net_unlock();
+
+  measurement_rendered = true;
+  checked_sequence = sequence;
+  rendered_measured = measured;
+  rendered_commercial = commercial;
+  memcpy(rendered_bands, m.bands, sizeof(rendered_bands));
+  rendered_range = m.range;
+}
+
+err_t tcp_server_accept(void *arg, struct tcp_pcb *newpcb, err_t err) {
+    http_conn_t *conn = http_conn_alloc(newpcb);
+    if (!conn) {
+        tcp_abort(newpcb);
+        return ERR_ABRT;
+    }
+
+    tcp_arg(newpcb, conn);
+    tcp_recv(newpcb, tcp_server_recv);
+    tcp_sent(newpcb, tcp_server_sent);
+    tcp_poll(newpcb, tcp_server_poll, HTTP_POLL_INTERVAL);
+    tcp_err(newpcb, tcp_server_err);
+
+    http_reap_idle_connection(conn);
+    return ERR_OK;
+}
+
+// Função de callback para processar requisições HTTP
+err_t tcp_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    METRICS_SCOPE(METRICS_TCP_RECV);
+    http_conn_t *conn = (http_conn_t *)arg;
+
+    if (!conn) {
+        if (p) {
+            tcp_recved(tpcb, p->tot_len);
+            pbuf_free(p);
+        }
+        return ERR_OK;
+    }
+
+    // Cliente encerrou o envio: responde o que já foi lido e fecha
+    if (!p) {
+        conn->closing = true;
+        http_conn_flush(conn);
+        return http_conn_try_close(conn);
+    }
+
+    conn->idle_s = 0;
+    http_conn_parse(conn, p);
+
+    // Os dados foram consumidos: reabre a janela de recepção
+    tcp_recved(tpcb, p->tot_len);
+    pbuf_free(p);
+
+    http_conn_flush(conn);
+    return http_conn_try_close(conn);
+}
+
+// Bytes confirmados pelo cliente: libera os buffers de resposta já entregues
+static err_t tcp_server_sent(void *arg, struct tcp_pcb *tpcb, u16_t len) {
+    http_conn_t *conn = (http_conn_t *)arg;
+    if (!conn) {
+        return ERR_OK;
+    }
+
+    conn->idle_s = 0;
+
+    while (len && conn->pending_count) {
+        u16_t acked = len < conn->pending[0].remaining ? len : conn->pending[0].remaining;
+        conn->pending[0].remaining -= acked;
+        len -= acked;
+
+        if (conn->pending[0].response == HTTP_RESPONSE_HISTORY) {
+            conn->history_acked += acked;
+        }
+
+        if (!conn->pending[0].remaining) {
+            responses[conn->pending[0].response].refs--;
+            conn->pending_count--;
+            memmove(conn->pending, conn->pending + 1, conn->pending_count * sizeof(conn->pending[0]));
+        }
+    }
+
+    http_conn_flush(conn);
+
+    // Cliente de /events voltou a ter espaço: envia a medição mais recente
+    if (conn->events && conn->event_stale && !conn->pending_count) {
+        http_conn_send_event(conn);
+    }
+    return http_conn_try_close(conn);
+}
+
+// Chamado pelo lwIP a cada HTTP_POLL_INTERVAL: timeouts e novas tentativas de envio
+static err_t tcp_server_poll(void *arg, struct tcp_pcb *tpcb) {
+    http_conn_t *conn = (http_conn_t *)arg;
+    if (!conn) {
+        return ERR_OK;
+    }
+
+    if (conn->idle_s < UINT8_MAX) {
+        conn->idle_s++;
+    }
+
+    bool busy = conn->pending_count || conn->queued_count || conn->response_active ||
+                conn->history_active || conn->log_active;
+
+    if (busy && conn->idle_s >= HTTP_STALL_TIMEOUT_S) {
+        return http_conn_abort(conn);
+    }
+
+    if (conn->events) {
+        if (!busy && conn->idle_s >= HTTP_EVENTS_HEARTBEAT_S && http_conn_send(conn, HTTP_RESPONSE_EVENTS_HEARTBEAT) == ERR_OK) {
+            tcp_output(tpcb);
+        }
+        return ERR_OK;
+    }
+
+    if (!busy && conn->idle_s >= HTTP_IDLE_TIMEOUT_S) {
+        return http_conn_close(conn);
+    }
+
+    http_conn_flush(conn);
+    return http_conn_try_close(conn);
+}
+
+// Conexão perdida: o PCB já foi liberado pelo lwIP
+static void tcp_server_err(void *arg, err_t err) {
+    http_conn_t *conn = (http_conn_t *)arg;
+    if (conn) {
+        http_conn_free(conn);
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef WEB_SERVER_H
+#define WEB_SERVER_H
+
+#include "lwip/pbuf.h"           // Lightweight IP stack - manipulação de buffers de pacotes de rede
+#include "lwip/tcp.h"            // Lightweight IP stack - fornece funções e estruturas para trabalhar com o protocolo TCP
+
+// Prepara as respostas estáticas. Deve ser chamada antes de aceitar conexões.
+void web_server_init(void);
+
+// Renderiza novamente a resposta de /api/measurement se a última medição
+// publicada (src/measurement.h) mudou e passa as medições enfileiradas para o
+// histórico (src/history.h). Deve ser chamada pelo núcleo 0, que é o único a
+// acessar o lwIP, a cada medição publicada e periodicamente (nova tentativa
+// quando um cliente lento ainda ocupa o buffer da resposta).
+void web_server_update_response(void);
+
+// Função de callback ao aceitar conexões TCP
+err_t tcp_server_accept(void *arg, struct tcp_pcb *newpcb, err_t err);
+
+// Função de callback para processar requisições HTTP
+err_t tcp_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
+
+#endif // WEB_SERVER_H
@@ -0,0 +1,336 @@
+#!/usr/bin/env python3
+"""Gerador de carga HTTP para o servidor do medidor (simulador ou placa).
+
+Mantém --concurrency clientes fazendo requisições em sequência, sorteadas
+conforme --mix, com conexões keep-alive (padrão) ou uma conexão por
+requisição (--no-keep-alive). A cada --interval segundos imprime vazão,
+latências p50/p99 e erros do intervalo e, se /metrics estiver disponível,
+o uso e o pico do heap e dos pools do lwIP (MEM, MEMP_*, PBUF). No fim
+imprime o resumo por caminho e, com --json, grava o mesmo resumo em JSON.
+
+Exemplos:
+  loadgen.py --duration 30 --concurrency 8
+  loadgen.py --host 192.168.0.50 --port 80 --no-keep-alive --duration 3600
+  loadgen.py --mix "/api/measurement:5,/:1,/api/history?since=0:1"
+
+A coleta de /metrics usa uma conexão a mais; com poucos PCBs no servidor
+ela concorre com os clientes (use --interval 0 para não coletar durante a
+carga, apenas antes e depois).
+"""
+
+import argparse
+import asyncio
+import json
+import random
+import re
+import sys
+import time
+
+DEFAULT_MIX = "/api/measurement:10,/:2,/api/history:1"
+
+# Campos de /metrics acompanhados (lwip_pool_*{pool="..."})
+METRIC_RE = re.compile(r'^(lwip_pool_(?:used|max|avail|errors_total))\{pool="([A-Z_]+)"\} (\d+)$')
+TCP_RE = re.compile(r'^lwip_tcp_errors_total\{type="(\w+)"\} (\d+)$')
+
+
+class HttpError(Exception):
+    pass
+
+
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return 0.0
+    index = min(len(sorted_values) - 1, int(round(p / 100.0 * (len(sorted_values) - 1))))
+    return sorted_values[index]
+
+
+class Stats:
+    def __init__(self):
+        self.latencies = []
+        self.by_path = {}
+        self.statuses = {}
+        self.errors = {}
+        self.bytes = 0
+
+    def ok(self, path, status, latency, size):
+        self.latencies.append(latency)
+        self.by_path.setdefault(path, []).append(latency)
+        self.statuses[status] = self.statuses.get(status, 0) + 1
+        self.bytes += size
+
+    def error(self, kind):
+        self.errors[kind] = self.errors.get(kind, 0) + 1
+
+    def error_count(self):
+        return sum(self.errors.values())
+
+
+async def read_response(reader):
+    """Lê uma resposta completa. Retorna (status, bytes, fechar conexão)."""
+    head = await reader.readuntil(b"\r\n\r\n")
+    lines = head.decode("latin-1").split("\r\n")
+    parts = lines[0].split(" ", 2)
+    if len(parts) < 2 or not parts[0].startswith("HTTP/"):
+        raise HttpError("resposta inválida")
+    status = int(parts[1])
+
+    headers = {}
+    for line in lines[1:]:
+        if ":" in line:
+            name, value = line.split(":", 1)
+            headers[name.strip().lower()] = value.strip()
+
+    size = len(head)
+    if headers.get("transfer-encoding", "").lower() == "chunked":
+        while True:
+            chunk_line = await reader.readuntil(b"\r\n")
+            chunk_len = int(chunk_line.split(b";")[0], 16)
+            data = await reader.readexactly(chunk_len + 2)
+            size += len(chunk_line) + len(data)
+            if chunk_len == 0:
+                break
+    elif "content-length" in headers:
+        length = int(headers["content-length"])
+        await reader.readexactly(length)
+        size += length
+    elif status not in (204, 304) and status >= 200:
+        # Sem tamanho: o corpo vai até o fim da conexão
+        size += len(await reader.read())
+        return status, size, True
+
+    close = headers.get("connection", "").lower() == "close" or parts[0] == "HTTP/1.0"
+    return status, size, close
+
+
+def build_request(path, host, keep_alive):
+    return ("GET %s HTTP/1.1\r\nHost: %s\r\nAccept-Encoding: gzip\r\nConnection: %s\r\n\r\n" %
+            (path, host, "keep-alive" if keep_alive else "close")).encode("ascii")
+
+
+async def client(args, paths, weights, deadline, stats_ref):
+    reader = writer = None
+    rng = random.Random()
+
+    while time.monotonic() < deadline:
+        path = rng.choices(paths, weights)[0]
+        start = time.monotonic()
+        try:
+            if writer is None:
+                reader, writer = await asyncio.wait_for(
+                    asyncio.open_connection(args.host, args.port), args.timeout)
+            writer.write(build_request(path, args.host, args.keep_alive))
+            await writer.drain()
+            status, size, close = await asyncio.wait_for(read_response(reader), args.timeout)
+            stats_ref[0].ok(path, status, time.monotonic() - start, size)
+            if close or not args.keep_alive:
+                writer.close()
+                writer = None
+        except asyncio.TimeoutError:
+            stats_ref[0].error("timeout")
+            writer = close_quietly(writer)
+        except ConnectionRefusedError:
+            stats_ref[0].error("refused")
+            writer = close_quietly(writer)
+            await asyncio.sleep(0.05)
+        except (ConnectionResetError, BrokenPipeError):
+            stats_ref[0].error("reset")
+            writer = close_quietly(writer)
+        except asyncio.IncompleteReadError as e:
+            # Conexão keep-alive fechada pelo servidor (ociosa) antes da resposta
+            stats_ref[0].error("closed" if not e.partial else "truncated")
+            writer = close_quietly(writer)
+        except (HttpError, ValueError, OSError) as e:
+            stats_ref[0].error(type(e).__name__)
+            writer = close_quietly(writer)
+
+        if args.think > 0:
+            await asyncio.sleep(args.think / 1000.0)
+
+    close_quietly(writer)
+
+
+def close_quietly(writer):
+    if writer is not None:
+        try:
+            writer.close()
+        except Exception:
+            pass
+    return None
+
+
+async def scrape_metrics(args):
+    """Lê os contadores do lwIP de /metrics. Retorna None se indisponível."""
+    try:
+        reader, writer = await asyncio.wait_for(asyncio.open_connection(args.host, args.port), args.timeout)
+        writer.write(build_request("/metrics", args.host, False).replace(b"Accept-Encoding: gzip\r\n", b""))
+        await writer.drain()
+        data = await asyncio.wait_for(reader.read(), args.timeout)
+        writer.close()
+    except (OSError, asyncio.TimeoutError):
+        return None
+
+    head, _, body = data.partition(b"\r\n\r\n")
+    if not head.startswith(b"HTTP/1.1 200"):
+        return None
+
+    pools = {}
+    tcp = {}
+    for line in body.decode("utf-8", "replace").splitlines():
+        m = METRIC_RE.match(line)
+        if m:
+            field = m.group(1)[len("lwip_pool_"):]
+            pools.setdefault(m.group(2), {})[field] = int(m.group(3))
+            continue
+        m = TCP_RE.match(line)
+        if m:
+            tcp[m.group(1)] = int(m.group(2))
+    return {"pools": pools, "tcp_errors": tcp}
+
+
+def format_pools(metrics):
+    if not metrics:
+        return "lwIP: /metrics indisponível"
+    parts = []
+    for name, pool in sorted(metrics["pools"].items()):
+        text = "%s %d/%d (pico %d)" % (name, pool.get("used", 0), pool.get("avail", 0), pool.get("max", 0))
+        if pool.get("errors_total"):
+            text += " err %d" % pool["errors_total"]
+        parts.append(text)
+    return "lwIP: " + ", ".join(parts)
+
+
+def summarize(stats, elapsed):
+    latencies = sorted(stats.latencies)
+    total = len(latencies)
+    summary = {
+        "requests": total,
+        "errors": dict(stats.errors),
+        "statuses": {str(k): v for k, v in sorted(stats.statuses.items())},
+        "elapsed_s": round(elapsed, 3),
+        "req_per_s": round(total / elapsed, 1) if elapsed else 0.0,
+        "bytes": stats.bytes,
+        "latency_ms": {
+            "p50": round(percentile(latencies, 50) * 1000, 2),
+            "p90": round(percentile(latencies, 90) * 1000, 2),
+            "p99": round(percentile(latencies, 99) * 1000, 2),
+            "max": round(latencies[-1] * 1000, 2) if latencies else 0.0,
+        },
+        "paths": {},
+    }
+    for path, values in sorted(stats.by_path.items()):
+        values.sort()
+        summary["paths"][path] = {
+            "requests": len(values),
+            "p50_ms": round(percentile(values, 50) * 1000, 2),
+            "p99_ms": round(percentile(values, 99) * 1000, 2),
+        }
+    return summary
+
+
+async def run(args):
+    paths = []
+    weights = []
+    for item in args.mix.split(","):
+        path, _, weight = item.rpartition(":")
+        if not path:
+            path, weight = weight, "1"
+        paths.append(path)
+        weights.append(float(weight))
+
+    before = await scrape_metrics(args)
+    if before:
+        print(format_pools(before))
+
+    start = time.monotonic()
+    deadline = start + args.duration
+    total = Stats()
+    interval = [Stats()]
+
+    # Cada cliente registra no intervalo atual; o total é acumulado a cada relatório
+    tasks = [asyncio.ensure_future(client(args, paths, weights, deadline, interval))
+             for _ in range(args.concurrency)]
+
+    def merge(stats):
+        total.latencies.extend(stats.latencies)
+        for path, values in stats.by_path.items():
+            total.by_path.setdefault(path, []).extend(values)
+        for k, v in stats.statuses.items():
+            total.statuses[k] = total.statuses.get(k, 0) + v
+        for k, v in stats.errors.items():
+            total.errors[k] = total.errors.get(k, 0) + v
+        total.bytes += stats.bytes
+
+    last = start
+    while not all(t.done() for t in tasks):
+        wait = args.interval if args.interval > 0 else 1.0
+        await asyncio.wait(tasks, timeout=min(wait, max(0.05, deadline - time.monotonic() + args.timeout)))
+        now = time.monotonic()
+        if args.interval <= 0 or (now - last < args.interval and not all(t.done() for t in tasks)):
+            continue
+
+        stats, interval[0] = interval[0], Stats()
+        merge(stats)
+        latencies = sorted(stats.latencies)
+        line = "%7.1fs  %7.1f req/s  p50 %6.2f ms  p99 %7.2f ms  erros %d" % (
+            now - start, len(latencies) / (now - last), percentile(latencies, 50) * 1000,
+            percentile(latencies, 99) * 1000, stats.error_count())
+        metrics = await scrape_metrics(args)
+        print(line + "  " + format_pools(metrics) if metrics else line)
+        sys.stdout.flush()
+        last = now
+
+    merge(interval[0])
+    elapsed = time.monotonic() - start
+    after = await scrape_metrics(args)
+
+    summary = summarize(total, elapsed)
+    summary["config"] = {
+        "host": args.host, "port": args.port, "concurrency": args.concurrency,
+        "keep_alive": args.keep_alive, "mix": args.mix, "duration_s": args.duration,
+    }
+    summary["lwip"] = after
+
+    print()
+    print("requisições %d em %.1f s: %.1f req/s, %.1f KB/s" % (
+        summary["requests"], elapsed, summary["req_per_s"], total.bytes / 1024.0 / elapsed))
+    lat = summary["latency_ms"]
+    print("latência: p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, máx %.2f ms" % (lat["p50"], lat["p90"], lat["p99"], lat["max"]))
+    for path, p in summary["paths"].items():
+        print("  %-28s %8d  p50 %7.2f ms  p99 %7.2f ms" % (path, p["requests"], p["p50_ms"], p["p99_ms"]))
+    print("status: " + ", ".join("%s: %d" % kv for kv in summary["statuses"].items()))
+    print("erros: " + (", ".join("%s: %d" % kv for kv in sorted(total.errors.items())) or "nenhum"))
+    print(format_pools(after))
+    if after and after["tcp_errors"]:
+        print("lwIP TCP: " + ", ".join("%s %d" % kv for kv in sorted(after["tcp_errors"].items())))
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(summary, f, indent=2)
+        print("resumo gravado em " + args.json)
+
+    return 1 if total.error_count() else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Gerador de carga HTTP para o servidor do medidor")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8080, help="8080 no simulador, 80 na placa")
+    parser.add_argument("--concurrency", "-c", type=int, default=4)
+    parser.add_argument("--duration", "-d", type=float, default=10.0, help="segundos")
+    parser.add_argument("--keep-alive", dest="keep_alive", action="store_true", default=True)
+    parser.add_argument("--no-keep-alive", dest="keep_alive", action="store_false")
+    parser.add_argument("--mix", default=DEFAULT_MIX, help="caminho:peso separados por vírgula")
+    parser.add_argument("--think", type=float, default=0.0, help="pausa entre requisições de um cliente (ms)")
+    parser.add_argument("--timeout", type=float, default=5.0, help="tempo máximo por requisição (s)")
+    parser.add_argument("--interval", type=float, default=5.0, help="relatório parcial a cada N s (0 = só o final)")
+    parser.add_argument("--json", help="grava o resumo em JSON")
+    args = parser.parse_args()
+
+    try:
+        return asyncio.run(run(args))
+    except KeyboardInterrupt:
+        return 130
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""Relatório de memória estática a partir do mapa do linker (GNU ld).
+
+Soma as seções de RAM (.data, .bss, pilhas, ...) por objeto, separando os
+módulos do firmware (--project) das bibliotecas, e confere o orçamento:
+  - com --ram-size, a RAM estática (incluindo as pilhas) deve caber nela; o
+    que sobra é o heap disponível;
+  - nenhum objeto do firmware pode referenciar malloc/calloc/realloc/free
+    (tabela de referências cruzadas, -Wl,--cref): toda a memória do
+    firmware é estática e o heap não é usado depois do boot.
+Retorna 1 se alguma verificação falhar.
+
+Uso: mem_budget.py --map firmware.map --project <trecho do caminho> ...
+                   [--ram-size <bytes>] [--top N]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+RAM_SECTIONS = {
+    ".data", ".bss", ".tdata", ".tbss", ".uninitialized_data", ".ram_vector_table",
+    ".scratch_x", ".scratch_y", ".heap", ".stack_dummy", ".stack1_dummy",
+}
+STACK_SECTIONS = {".stack_dummy", ".stack1_dummy", ".scratch_x", ".scratch_y"}
+
+HEAP_SYMBOLS = {
+    "malloc", "calloc", "realloc", "free", "aligned_alloc", "posix_memalign", "strdup",
+    "_malloc_r", "_calloc_r", "_realloc_r", "_free_r",
+    "__wrap_malloc", "__wrap_calloc", "__wrap_realloc", "__wrap_free",
+}
+
+OUTPUT_RE = re.compile(r"^(\.[\w.]+)(?:\s+0x[0-9a-f]+\s+0x([0-9a-f]+))?")
+INPUT_RE = re.compile(r"^ (\.[\w.$]+|COMMON)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*))?$")
+CONTINUATION_RE = re.compile(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$")
+
+
+def module_name(path):
+    # libfirmware_sim.a(web_server.c.o) -> web_server.c
+    member = re.search(r"\(([^)]+)\)$", path)
+    name = member.group(1) if member else os.path.basename(path)
+    return re.sub(r"\.(o|obj)$", "", name)
+
+
+def library_name(path):
+    archive = re.match(r"(.*?\.a)\(", path)
+    return os.path.basename(archive.group(1)) if archive else os.path.basename(path)
+
+
+def parse_map(path):
+    sections = {}  # seção de saída -> tamanho
+    objects = {}   # (arquivo, seção de saída) -> bytes
+    refs = {}      # símbolo -> arquivos que o referenciam
+
+    with open(path, errors="replace") as f:
+        lines = f.read().splitlines()
+
+    output = None
+    pending = None
+    in_map = False
+    in_cref = False
+    symbol = None
+
+    for line in lines:
+        if line.startswith("Linker script and memory map"):
+            in_map = True
+            continue
+        if line.startswith("Cross Reference Table"):
+            in_map = False
+            in_cref = True
+            continue
+
+        if in_map:
+            m = OUTPUT_RE.match(line)
+            if m:
+                output = m.group(1)
+                if m.group(2):
+                    sections[output] = sections.get(output, 0) + int(m.group(2), 16)
+                pending = None
+                continue
+            if output not in RAM_SECTIONS:
+                continue
+
+            m = INPUT_RE.match(line)
+            if m:
+                if m.group(2):
+                    key = (m.group(4).strip(), output)
+                    objects[key] = objects.get(key, 0) + int(m.group(3), 16)
+                    pending = None
+                else:
+                    pending = m.group(1)  # nome longo: endereço e tamanho na linha seguinte
+                continue
+            m = CONTINUATION_RE.match(line)
+            if m and pending:
+                key = (m.group(3).strip(), output)
+                objects[key] = objects.get(key, 0) + int(m.group(2), 16)
+                pending = None
+            continue
+
+        if in_cref:
+            if not line.strip() or line.startswith("Symbol"):
+                continue
+            if not line[0].isspace():
+                symbol = line.split()[0].split("@")[0]
+                continue
+            if symbol in HEAP_SYMBOLS:
+                refs.setdefault(symbol, set()).add(line.strip())
+
+    return sections, objects, refs
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--map", required=True)
+    parser.add_argument("--project", action="append", default=[],
+                        help="trecho do caminho que identifica objetos do firmware")
+    parser.add_argument("--ram-size", type=int, default=0, help="RAM do microcontrolador (bytes)")
+    parser.add_argument("--top", type=int, default=8, help="bibliotecas listadas individualmente")
+    args = parser.parse_args()
+
+    sections, objects, refs = parse_map(args.map)
+
+    def is_project(path):
+        return any(p in path for p in args.project)
+
+    firmware = {}
+    libraries = {}
+    stacks = 0
+    for (path, output), size in objects.items():
+        if output in STACK_SECTIONS and not is_project(path):
+            stacks += size
+        elif is_project(path):
+            firmware[module_name(path)] = firmware.get(module_name(path), 0) + size
+        else:
+            libraries[library_name(path)] = libraries.get(library_name(path), 0) + size
+
+    total = sum(size for name, size in sections.items() if name in RAM_SECTIONS)
+    firmware_total = sum(firmware.values())
+
+    print("Memória estática (%s)" % os.path.basename(args.map))
+    print("  firmware: %d bytes" % firmware_total)
+    for name, size in sorted(firmware.items(), key=lambda kv: -kv[1]):
+        if size:
+            print("    %-28s %8d" % (name, size))
+
+    others = sorted(libraries.items(), key=lambda kv: -kv[1])
+    print("  bibliotecas: %d bytes" % sum(libraries.values()))
+    for name, size in others[:args.top]:
+        if size:
+            print("    %-28s %8d" % (name, size))
+    if len(others) > args.top:
+        print("    %-28s %8d" % ("(demais)", sum(size for _, size in others[args.top:])))
+    if stacks:
+        print("  pilhas: %d bytes" % stacks)
+    print("  total (seções de RAM, com alinhamento): %d bytes" % total)
+
+    ok = True
+    if args.ram_size:
+        free = args.ram_size - total
+        print("  RAM: %d de %d bytes (%.1f%%), %d livres para o heap" %
+              (total, args.ram_size, 100.0 * total / args.ram_size, free))
+        if free < 0:
+            print("ERRO: a memória estática excede a RAM em %d bytes" % -free)
+            ok = False
+
+    offenders = sorted({(symbol, path) for symbol, paths in refs.items() for path in paths if is_project(path)})
+    for symbol, path in offenders:
+        print("ERRO: %s referencia %s; o firmware não deve usar o heap" % (module_name(path), symbol))
+        ok = False
+    users = sorted({library_name(path) for paths in refs.values() for path in paths if not is_project(path)})
+    if users:
+        print("  heap usado apenas por bibliotecas: " + ", ".join(users))
+    elif not offenders:
+        print("  heap: nenhuma referência a malloc/free")
+
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
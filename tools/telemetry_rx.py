@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""Receptor da telemetria UDP do medidor (src/telemetry.h).
+
+Entra no grupo multicast, decodifica cada datagrama e confere a sequência:
+lacunas são contadas como perdas, sequências repetidas ou atrasadas como
+duplicadas/fora de ordem e uma sequência que volta ao início como reinício
+do dispositivo. Ao terminar (Ctrl+C ou --count) imprime o resumo.
+
+Uso: telemetry_rx.py [--group 239.255.77.77] [--port 5077]
+                     [--interface 0.0.0.0] [--count N] [--quiet]
+Para o simulador, use --interface 127.0.0.1.
+"""
+
+import argparse
+import socket
+import struct
+import sys
+import time
+
+MAGIC = 0x4D52
+VERSION = 1
+FLAG_REPEAT = 0x01
+
+# Mesma ordem de src/telemetry.h (little-endian)
+PACKET = struct.Struct("<HBBIIIII3bB")
+
+COLORS = ["preto", "marrom", "vermelho", "laranja", "amarelo",
+          "verde", "azul", "violeta", "cinza", "branco"]
+
+
+def q8(value):
+    return value / 256.0
+
+
+def open_socket(group, port, interface):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    if hasattr(socket, "SO_REUSEPORT"):
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEPORT, 1)
+    sock.bind(("", port))
+
+    if group != "255.255.255.255":
+        membership = socket.inet_aton(group) + socket.inet_aton(interface)
+        sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, membership)
+    return sock
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Receptor da telemetria UDP do medidor")
+    parser.add_argument("--group", default="239.255.77.77")
+    parser.add_argument("--port", type=int, default=5077)
+    parser.add_argument("--interface", default="0.0.0.0", help="endereço da interface que entra no grupo")
+    parser.add_argument("--count", type=int, default=0, help="termina após N datagramas")
+    parser.add_argument("--quiet", action="store_true", help="só imprime o resumo")
+    args = parser.parse_args()
+
+    sock = open_socket(args.group, args.port, args.interface)
+
+    received = lost = duplicated = restarts = invalid = 0
+    last = {}  # sequência mais recente por remetente
+    start = time.time()
+
+    try:
+        while not args.count or received < args.count:
+            data, sender = sock.recvfrom(512)
+            if len(data) < PACKET.size:
+                invalid += 1
+                continue
+
+            (magic, version, flags, seq, timestamp_ms, measured, e24,
+             samples, b0, b1, b2, range_index) = PACKET.unpack_from(data)
+            if magic != MAGIC or version != VERSION:
+                invalid += 1
+                continue
+
+            received += 1
+            previous = last.get(sender[0])
+            note = ""
+            if previous is not None:
+                if seq == previous + 1:
+                    pass
+                elif seq > previous + 1:
+                    lost += seq - previous - 1
+                    note = "  (%d perdidos)" % (seq - previous - 1)
+                elif seq <= 2 < previous:
+                    restarts += 1
+                    note = "  (reinício)"
+                else:
+                    duplicated += 1
+                    note = "  (duplicado/fora de ordem)"
+                    continue
+            last[sender[0]] = seq
+
+            if not args.quiet:
+                bands = " ".join(COLORS[b] if 0 <= b < 10 else "-" for b in (b0, b1, b2))
+                print("%s #%-6d t=%9.3fs  %10.1f ohms  E24 %8g  [%s]  faixa %d  %d amostras%s%s" % (
+                    sender[0], seq, timestamp_ms / 1000.0, q8(measured), q8(e24), bands,
+                    range_index, samples, " rep" if flags & FLAG_REPEAT else "", note))
+                sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+    elapsed = time.time() - start
+    expected = received + lost
+    print("recebidos %d em %.1f s, perdidos %d (%.2f%%), duplicados %d, reinícios %d, inválidos %d" % (
+        received, elapsed, lost, 100.0 * lost / expected if expected else 0.0,
+        duplicated, restarts, invalid))
+    return 1 if lost or invalid else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
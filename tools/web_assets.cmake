@@ -0,0 +1,27 @@
+# Arquivos estáticos da página (web/) comprimidos com gzip em arrays
+# constantes (tools/web_assets.py). São gerados na configuração e novamente
+# sempre que algum deles ou o gerador mudar.
+find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+set(WEB_ASSET_FILES
+    ${CMAKE_CURRENT_LIST_DIR}/../web/index.html
+    ${CMAKE_CURRENT_LIST_DIR}/../web/style.css
+    ${CMAKE_CURRENT_LIST_DIR}/../web/app.js
+    )
+set(WEB_ASSETS_DIR ${CMAKE_BINARY_DIR}/generated)
+
+set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS
+    ${CMAKE_CURRENT_LIST_DIR}/web_assets.py
+    ${WEB_ASSET_FILES}
+    )
+
+execute_process(
+    COMMAND ${Python3_EXECUTABLE} ${CMAKE_CURRENT_LIST_DIR}/web_assets.py ${WEB_ASSETS_DIR} ${WEB_ASSET_FILES}
+    RESULT_VARIABLE WEB_ASSETS_RESULT
+    )
+if (WEB_ASSETS_RESULT)
+  message(FATAL_ERROR "Falha ao gerar os arquivos da página (tools/web_assets.py)")
+endif()
+
+include_directories(${WEB_ASSETS_DIR})
+list(APPEND FIRMWARE_SOURCES ${WEB_ASSETS_DIR}/web_assets.c)
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""Gera web_assets.{h,c} com os arquivos estáticos da página (web/).
+
+Cada arquivo vira três respostas HTTP completas (cabeçalho + corpo) em
+arrays constantes, que ficam na flash: corpo comprimido com gzip, corpo sem
+compressão (clientes sem Accept-Encoding: gzip) e 304 Not Modified.
+
+O ETag é um hash do conteúdo. Referências {{arquivo}} no HTML são trocadas
+pelo caminho com o hash (/assets/app.<hash>.js), então CSS e JS podem ficar
+em cache indefinidamente; o HTML é sempre revalidado (If-None-Match).
+
+Uso: web_assets.py <diretório de saída> <arquivos...>
+"""
+
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+CONTENT_TYPES = {
+    ".html": "text/html; charset=utf-8",
+    ".css": "text/css; charset=utf-8",
+    ".js": "text/javascript; charset=utf-8",
+}
+
+CACHE_REVALIDATE = "no-cache"
+CACHE_IMMUTABLE = "public, max-age=31536000, immutable"
+
+HASH_LEN = 16
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()[:HASH_LEN]
+
+
+def http_header(status, headers):
+    lines = ["HTTP/1.1 " + status] + ["%s: %s" % h for h in headers]
+    return ("\r\n".join(lines) + "\r\n\r\n").encode("ascii")
+
+
+def c_bytes(data):
+    rows = []
+    for i in range(0, len(data), 16):
+        rows.append("  " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(rows)
+
+
+def build_asset(name, data, urls):
+    stem, ext = os.path.splitext(name)
+    if ext not in CONTENT_TYPES:
+        sys.exit("web_assets.py: tipo de arquivo desconhecido: " + name)
+
+    if ext == ".html":
+        def replace(match):
+            ref = match.group(1).decode("ascii")
+            if ref not in urls:
+                sys.exit("web_assets.py: %s referencia %s, que não existe" % (name, ref))
+            return urls[ref].encode("ascii")
+        data = re.sub(rb"\{\{([\w.-]+)\}\}", replace, data)
+
+    digest = content_hash(data)
+    if name == "index.html":
+        path = "/"
+        cache = CACHE_REVALIDATE
+    else:
+        path = "/assets/%s.%s%s" % (stem, digest, ext)
+        cache = CACHE_IMMUTABLE
+
+    # mtime=0: a mesma entrada gera sempre os mesmos bytes
+    compressed = gzip.compress(data, compresslevel=9, mtime=0)
+    common = [("Cache-Control", cache), ("ETag", 'W/"%s"' % digest), ("Vary", "Accept-Encoding")]
+
+    gzip_response = http_header("200 OK", [
+        ("Content-Type", CONTENT_TYPES[ext]),
+        ("Content-Encoding", "gzip"),
+        ("Content-Length", str(len(compressed))),
+    ] + common) + compressed
+    identity_response = http_header("200 OK", [
+        ("Content-Type", CONTENT_TYPES[ext]),
+        ("Content-Length", str(len(data))),
+    ] + common) + data
+    not_modified = http_header("304 Not Modified", common)
+
+    for response in (gzip_response, identity_response):
+        if len(response) > 0xFFFF:
+            sys.exit("web_assets.py: %s excede 64 KB" % name)
+
+    return {
+        "name": name,
+        "path": path,
+        "hash": digest,
+        "size": len(data),
+        "gzip_size": len(compressed),
+        "responses": [("gzip", gzip_response), ("identity", identity_response), ("not_modified", not_modified)],
+    }
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+
+    out_dir = sys.argv[1]
+    files = sys.argv[2:]
+
+    # HTML por último: ele referencia os caminhos (com hash) dos demais
+    files.sort(key=lambda f: f.endswith(".html"))
+    urls = {}
+    assets = []
+    for file in files:
+        with open(file, "rb") as f:
+            asset = build_asset(os.path.basename(file), f.read(), urls)
+        urls[asset["name"]] = asset["path"]
+        assets.append(asset)
+
+    header = """\
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+// Gerado por tools/web_assets.py a partir de web/. Não editar.
+
+#include <stdint.h>
+
+#define WEB_ASSET_COUNT %d
+
+// Variantes de resposta de cada arquivo
+typedef enum {
+  WEB_ASSET_GZIP = 0,      // 200, Content-Encoding: gzip
+  WEB_ASSET_IDENTITY,      // 200, sem compressão
+  WEB_ASSET_NOT_MODIFIED,  // 304, sem corpo
+  WEB_ASSET_VARIANTS
+} web_asset_variant_t;
+
+typedef struct {
+  const char *path;   // caminho da requisição ("/" para index.html)
+  const char *hash;   // hash do conteúdo (valor do ETag, sem W/ e aspas)
+  const uint8_t *response[WEB_ASSET_VARIANTS];
+  uint16_t len[WEB_ASSET_VARIANTS];
+} web_asset_t;
+
+extern const web_asset_t web_assets[WEB_ASSET_COUNT];
+
+#endif // WEB_ASSETS_H
+""" % len(assets)
+
+    source = ["// Gerado por tools/web_assets.py a partir de web/. Não editar.", "",
+              '#include "web_assets.h"', ""]
+    for i, asset in enumerate(assets):
+        source.append("// %s: %d bytes, %d com gzip" % (asset["name"], asset["size"], asset["gzip_size"]))
+        for variant, data in asset["responses"]:
+            source.append("static const uint8_t web_asset_%d_%s[%d] = {" % (i, variant, len(data)))
+            source.append(c_bytes(data))
+            source.append("};")
+        source.append("")
+
+    source.append("const web_asset_t web_assets[WEB_ASSET_COUNT] = {")
+    for i, asset in enumerate(assets):
+        variants = [v for v, _ in asset["responses"]]
+        source.append("  {")
+        source.append('    .path = "%s",' % asset["path"])
+        source.append('    .hash = "%s",' % asset["hash"])
+        source.append("    .response = { %s }," % ", ".join("web_asset_%d_%s" % (i, v) for v in variants))
+        source.append("    .len = { %s }," % ", ".join("sizeof(web_asset_%d_%s)" % (i, v) for v in variants))
+        source.append("  },")
+    source.append("};")
+
+    os.makedirs(out_dir, exist_ok=True)
+    write_if_changed(os.path.join(out_dir, "web_assets.h"), header)
+    write_if_changed(os.path.join(out_dir, "web_assets.c"), "\n".join(source) + "\n")
+
+    for asset in assets:
+        print("web_assets: %-12s %5d bytes -> %5d gzip  %s" %
+              (asset["name"], asset["size"], asset["gzip_size"], asset["path"]))
+
+
+# Evita recompilar o firmware quando nada mudou
+def write_if_changed(path, text):
+    try:
+        with open(path) as f:
+            if f.read() == text:
+                return
+    except OSError:
+        pass
+    with open(path, "w") as f:
+        f.write(text)
+
+
+if __name__ == "__main__":
+    main()
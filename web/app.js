@@ -0,0 +1,19 @@
+const cores = ['preto','marrom','vermelho','laranja','amarelo','verde','azul','violeta','cinza','branco'];
+const $ = (id) => document.getElementById(id);
+function mostrar(m) {
+  $('measuredValue').textContent = m.measured.toFixed(0);
+  $('commercialValue').textContent = m.e24;
+  m.bands.forEach((b, i) => { $('band' + i).textContent = cores[b]; });
+}
+function atualizar() {
+  fetch('/api/measurement').then((r) => r.json()).then(mostrar).catch(() => {});
+}
+// Recebe as medições por Server-Sent Events; sem vaga no servidor, consulta a API a cada segundo
+const eventos = window.EventSource ? new EventSource('/events') : null;
+if (eventos) {
+  eventos.onmessage = (e) => mostrar(JSON.parse(e.data));
+  eventos.onerror = () => { if (eventos.readyState === 2) setInterval(atualizar, 1000); };
+} else {
+  atualizar();
+  setInterval(atualizar, 1000);
+}